@@ -0,0 +1,158 @@
+/*
+	NovaCorps - BlockPool.h
+
+	This header file describes the BlockPool class.
+
+		A BlockPool is a pool of raw, uninitialised blocks of memory that are all the same size. It's
+	what the pools of objects are to types, but for bytes, and is the building block of the
+	PoolAllocator (see PoolAllocator.h).
+
+		Blocks are carved out of larger chunks, allocated as they're needed. A free block holds the
+	address of the next free block inside itself, so handing out and taking back a block is just
+	popping and pushing a list, and the pool needs no memory of its own to track them. Chunks are
+	only returned to the system when the BlockPool is destroyed.
+
+		A BlockPool is not thread-safe.
+
+*/
+
+
+#ifndef BLOCK_POOL_H
+
+	#define BLOCK_POOL_H
+
+	#include <cstddef>
+	#include <new>
+	#include <vector>
+
+	class BlockPool
+	{
+		//Private members
+		private:
+
+			//Size of each block, which is at least big enough to hold the free list link
+			std::size_t m_iBlockSize;
+
+			//Every block is aligned to at least this
+			std::size_t m_iAlignment;
+
+			//Number of blocks carved out of each chunk
+			int m_iBlocksPerChunk;
+
+			//First free block, each of which holds the address of the next
+			void* m_pFreeList = nullptr;
+
+			//Every chunk allocated so far, so they can be freed at the end
+			std::vector<void*> m_vChunks;
+
+			//Number of blocks currently handed out
+			int m_iActive = 0;
+
+
+			//Allocates a new chunk and puts all of its blocks on the free list
+			bool addChunk()
+			{
+				void* l_pChunk = ::operator new(m_iBlockSize * m_iBlocksPerChunk, std::align_val_t(m_iAlignment), std::nothrow);
+				if (l_pChunk == nullptr) return false;
+
+				m_vChunks.push_back(l_pChunk);
+
+				//Link the blocks back to front, so they're handed out in address order
+				char* l_pBlocks = static_cast<char*>(l_pChunk);
+				for (int i = m_iBlocksPerChunk - 1; i >= 0; i--)
+				{
+					void* l_pBlock = l_pBlocks + m_iBlockSize * i;
+					*static_cast<void**>(l_pBlock) = m_pFreeList;
+					m_pFreeList = l_pBlock;
+				}
+
+				return true;
+			}
+
+
+		//Public members
+		public:
+
+			//Creates a pool of blocks of at least a_iBlockSize bytes, each aligned to a_iAlignment (a power of two), carved out of
+			//chunks of a_iBlocksPerChunk blocks. No memory is allocated until the first block is asked for
+			explicit BlockPool(const std::size_t a_iBlockSize, const int a_iBlocksPerChunk = 64, const std::size_t a_iAlignment = alignof(std::max_align_t))
+			{
+				m_iAlignment = a_iAlignment > alignof(void*) ? a_iAlignment : alignof(void*);
+
+				//Round the block size up so it can hold a link, and so every block in a chunk lands on the alignment
+				std::size_t l_iBlockSize = a_iBlockSize > sizeof(void*) ? a_iBlockSize : sizeof(void*);
+				m_iBlockSize = (l_iBlockSize + m_iAlignment - 1) / m_iAlignment * m_iAlignment;
+
+				m_iBlocksPerChunk = a_iBlocksPerChunk > 0 ? a_iBlocksPerChunk : 1;
+			}
+
+			//The pool owns its chunks outright, so it can't be copied
+			BlockPool(const BlockPool&) = delete;
+			BlockPool& operator=(const BlockPool&) = delete;
+
+			//Destructor. Frees every chunk, whether or not its blocks were given back
+			~BlockPool()
+			{
+				for (void* l_pChunk : m_vChunks)
+				{
+					::operator delete(l_pChunk, std::align_val_t(m_iAlignment));
+				}
+			}
+
+
+			//Returns a free block, allocating a new chunk first if there are none. Returns nullptr if the system is out of memory
+			void* allocate()
+			{
+				if (m_pFreeList == nullptr && !addChunk())
+				{
+					//throw std::bad_alloc();
+					return nullptr;
+				}
+
+				void* l_pBlock = m_pFreeList;
+				m_pFreeList = *static_cast<void**>(l_pBlock);
+				m_iActive++;
+
+				return l_pBlock;
+			}
+
+			//Gives a block back to the pool. It must have come from this pool's allocate()
+			void deallocate(void* a_pBlock)
+			{
+				if (a_pBlock == nullptr) return;
+
+				*static_cast<void**>(a_pBlock) = m_pFreeList;
+				m_pFreeList = a_pBlock;
+				m_iActive--;
+			}
+
+
+			//Getter for the size of each block
+			std::size_t blockSize() const
+			{
+				return m_iBlockSize;
+			}
+
+			//Getter for the alignment of each block
+			std::size_t alignment() const
+			{
+				return m_iAlignment;
+			}
+
+			//Returns number of blocks currently handed out
+			int activeCount() const
+			{
+				return m_iActive;
+			}
+
+			//Returns number of chunks allocated so far
+			int chunkCount() const
+			{
+				return static_cast<int>(m_vChunks.size());
+			}
+
+
+	};
+
+
+#endif
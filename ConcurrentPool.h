@@ -0,0 +1,314 @@
+/*
+	NovaCorps - ConcurrentPool.h
+
+	This header file describes the ConcurrentPool class.
+
+		A ConcurrentPool is a fixed size pool of objects that any number of threads can call
+	.getNext() and .release(object) on at the same time, without locking.
+
+		Like a SlabPool (see SlabPool.h), all of the objects are constructed up front in one
+	contiguous block of memory. Rather than splitting an array into active and free halves, the
+	free objects are kept on a lock-free stack: each free object records the index of the free
+	object below it, and the top of the stack is a single atomic word holding both the index of the
+	top object and a tag that is bumped on every change. The tag means a thread that was
+	interrupted mid-operation can't be fooled by the stack being popped and pushed back to the same
+	top object in the meantime (the ABA problem).
+
+		Because there is no active half, a ConcurrentPool can't list its active objects. Releasing
+	an object twice is not detected, so make sure each object is released exactly once.
+
+*/
+
+
+#ifndef CONCURRENT_POOL_H
+
+	#define CONCURRENT_POOL_H
+
+	#include <atomic>
+	#include <cstddef>
+	#include <cstdint>
+	#include <new>
+
+	#include "PoolHandle.h"
+	#include "PoolTraits.h"
+
+	template <class type>
+	class PoolMagazine;
+
+	template <class type>
+	class ConcurrentPool
+	{
+		//Magazines hand back objects that were already reset when released into them
+		friend class PoolMagazine<type>;
+
+		//Private members
+		private:
+
+			//Objects are aligned to at least a cache line so the slab starts on a line boundary
+			static constexpr std::size_t s_iAlignment = alignof(type) > 64 ? alignof(type) : 64;
+
+			//Index stored in the top of the stack when there are no free objects left
+			static constexpr std::uint32_t s_iEmpty = 0xFFFFFFFFu;
+
+			//The Size of the pool [default 10]
+			int m_iSize = 10;
+
+			//The single block of memory every object in the pool is constructed in
+			type* m_pSlab = nullptr;
+
+			//For each free object, the slab index of the next free object beneath it on the stack
+			std::atomic<std::uint32_t>* m_pNextFree = nullptr;
+
+			//Top of the free stack: tag in the high 32 bits, slab index of the top object in the low 32 bits.
+			//Kept last and on its own cache line, as every getNext and release touches it
+			alignas(64) std::atomic<std::uint64_t> m_iFreeTop;
+
+
+			//Packs a tag and an index into a single top of stack value
+			static std::uint64_t pack(const std::uint64_t a_iTag, const std::uint32_t a_iIndex)
+			{
+				return (a_iTag << 32) | a_iIndex;
+			}
+
+			//Allocates the slab, constructs objects in it with the given function, and puts them all on the free stack
+			template <class construct>
+			void build(const int a_iSize, construct a_construct)
+			{
+				if (a_iSize <= 0)
+				{
+					//throw std::range_error(__FILE__ ": <ConcurrentPool Error>: Pool must have size greater than 0");
+					m_iSize = 0;
+					m_iFreeTop.store(pack(0, s_iEmpty), std::memory_order_relaxed);
+					return;
+				}
+
+				m_iSize = a_iSize;
+				m_pSlab = static_cast<type*>(::operator new(sizeof(type) * a_iSize, std::align_val_t(s_iAlignment)));
+				m_pNextFree = new std::atomic<std::uint32_t>[a_iSize];
+
+				//Chain every object onto the free stack in order, so the first getNext returns the start of the slab
+				for (int i = 0; i < a_iSize; i++)
+				{
+					a_construct(m_pSlab + i);
+					m_pNextFree[i].store(i + 1 < a_iSize ? static_cast<std::uint32_t>(i + 1) : s_iEmpty, std::memory_order_relaxed);
+				}
+
+				m_iFreeTop.store(pack(0, 0), std::memory_order_release);
+			}
+
+			//Returns the index in the slab of the given address, or -1 if it doesn't point to an object in this slab
+			int slabIndex(const type* a_pAddress) const
+			{
+				const std::uintptr_t l_iStart = reinterpret_cast<std::uintptr_t>(m_pSlab);
+				const std::uintptr_t l_iAddress = reinterpret_cast<std::uintptr_t>(a_pAddress);
+
+				if (l_iAddress < l_iStart || l_iAddress >= l_iStart + sizeof(type) * m_iSize) return -1;
+				if ((l_iAddress - l_iStart) % sizeof(type) != 0) return -1;
+
+				return static_cast<int>((l_iAddress - l_iStart) / sizeof(type));
+			}
+
+			//Puts the given objects back on the free stack with a single swap, without resetting them
+			void pushChain(type** a_pAddresses, const int a_iCount)
+			{
+				//Link the objects into a chain first, so the whole chain can go onto the stack with a single swap
+				int l_iFirst = -1;
+				int l_iLast = -1;
+
+				for (int i = 0; i < a_iCount; i++)
+				{
+					const int i_slabIndex = slabIndex(a_pAddresses[i]);
+
+					if (i_slabIndex < 0)
+					{
+						//throw std::range_error(__FILE__ ": <ConcurrentPool Error>: Given Address was not found in pool");
+						continue;
+					}
+
+					if (l_iLast < 0) l_iFirst = i_slabIndex;
+					else m_pNextFree[l_iLast].store(static_cast<std::uint32_t>(i_slabIndex), std::memory_order_relaxed);
+
+					l_iLast = i_slabIndex;
+				}
+
+				if (l_iFirst < 0) return;
+
+				std::uint64_t l_iTop = m_iFreeTop.load(std::memory_order_relaxed);
+
+				do
+				{
+					m_pNextFree[l_iLast].store(static_cast<std::uint32_t>(l_iTop), std::memory_order_relaxed);
+				}
+				while (!m_iFreeTop.compare_exchange_weak(l_iTop, pack((l_iTop >> 32) + 1, static_cast<std::uint32_t>(l_iFirst)), std::memory_order_release, std::memory_order_relaxed));
+			}
+
+
+		//Public members
+		public:
+
+			//Creates a ConcurrentPool of a_size with default objects of given type
+			ConcurrentPool(const int a_iSize = 10)
+			{
+				build(a_iSize, [](type* a_pPlace) { new (a_pPlace) type(); });
+			}
+
+			//Creates a ConcurrentPool of a_size objects cloned from the given object
+			ConcurrentPool(const type* a_pObjectToPool, const int a_iSize)
+			{
+				build(a_iSize, [a_pObjectToPool](type* a_pPlace) { new (a_pPlace) type(*a_pObjectToPool); });
+			}
+
+			//The slab owns its objects outright, so a ConcurrentPool can't be copied
+			ConcurrentPool(const ConcurrentPool&) = delete;
+			ConcurrentPool& operator=(const ConcurrentPool&) = delete;
+
+			//Destructor. No other thread may be using the pool by the time it is destroyed
+			virtual ~ConcurrentPool()
+			{
+				for (int i = 0; i < m_iSize; i++)
+				{
+					m_pSlab[i].~type();
+				}
+
+				if (m_pSlab != nullptr) ::operator delete(m_pSlab, std::align_val_t(s_iAlignment));
+				delete[] m_pNextFree;
+			}
+
+
+			//Retrieves the next object in the pool, or nullptr if every object is in use. Safe to call from any thread
+			type* getNext()
+			{
+				std::uint64_t l_iTop = m_iFreeTop.load(std::memory_order_acquire);
+
+				for (;;)
+				{
+					const std::uint32_t l_iIndex = static_cast<std::uint32_t>(l_iTop);
+
+					if (l_iIndex == s_iEmpty)
+					{
+						//throw std::overflow_error(__FILE__ ": <ConcurrentPool Error>: No available objects left in pool. Try releasing some objects");
+						return nullptr;
+					}
+
+					//This may read a stale link if another thread pops the object first, but then the tag will have changed and the swap below fails
+					const std::uint32_t l_iNext = m_pNextFree[l_iIndex].load(std::memory_order_relaxed);
+
+					if (m_iFreeTop.compare_exchange_weak(l_iTop, pack((l_iTop >> 32) + 1, l_iNext), std::memory_order_acquire, std::memory_order_acquire))
+					{
+						return m_pSlab + l_iIndex;
+					}
+				}
+			}
+
+
+			//Retrieves the next object in the pool wrapped in a handle that releases it when the handle is destroyed.
+			//The handle is empty if there was nothing free. Safe to call from any thread
+			PoolHandle<type, ConcurrentPool<type>> acquire()
+			{
+				return PoolHandle<type, ConcurrentPool<type>>(getNext(), this);
+			}
+
+
+			//Retrieves the next object in the pool and gives it a fresh value constructed from the given arguments, in place where possible
+			//(see PoolTraits.h). Returns nullptr if there was nothing free. Safe to call from any thread
+			template <class... args>
+			type* emplaceNext(args&&... a_args)
+			{
+				type* l_pObject = getNext();
+
+				if (l_pObject != nullptr) PoolReinitialise<type>::apply(l_pObject, std::forward<args>(a_args)...);
+
+				return l_pObject;
+			}
+
+			//As emplaceNext, but wraps the object in a handle that releases it when the handle is destroyed. Safe to call from any thread
+			template <class arg, class... args>
+			PoolHandle<type, ConcurrentPool<type>> acquire(arg&& a_arg, args&&... a_args)
+			{
+				return PoolHandle<type, ConcurrentPool<type>>(emplaceNext(std::forward<arg>(a_arg), std::forward<args>(a_args)...), this);
+			}
+
+
+			//Retrieves up to a_iCount objects in one go, writing them to a_pOut, and returns how many were retrieved. Safe to call from any thread
+			int getNext(const int a_iCount, type** a_pOut)
+			{
+				std::uint64_t l_iTop = m_iFreeTop.load(std::memory_order_acquire);
+
+				for (;;)
+				{
+					//Walk down the stack from the top. If anything changes while we do, the tag changes and the swap below fails
+					int l_iTaken = 0;
+					std::uint32_t l_iIndex = static_cast<std::uint32_t>(l_iTop);
+
+					while (l_iTaken < a_iCount && l_iIndex != s_iEmpty)
+					{
+						a_pOut[l_iTaken++] = m_pSlab + l_iIndex;
+						l_iIndex = m_pNextFree[l_iIndex].load(std::memory_order_relaxed);
+					}
+
+					if (l_iTaken == 0) return 0;
+
+					//Whatever was beneath the last object we took becomes the new top
+					if (m_iFreeTop.compare_exchange_weak(l_iTop, pack((l_iTop >> 32) + 1, l_iIndex), std::memory_order_acquire, std::memory_order_acquire))
+					{
+						return l_iTaken;
+					}
+				}
+			}
+
+
+			//Releases the object at the given address back to the pool. Safe to call from any thread
+			void release(type* a_pAddress)
+			{
+				const int i_slabIndex = slabIndex(a_pAddress);
+
+				if (i_slabIndex < 0)
+				{
+					//throw std::range_error(__FILE__ ": <ConcurrentPool Error>: Given Address was not found in pool");
+					return;
+				}
+
+				//Let the object clear itself out before it goes back in the pool
+				PoolReset<type>::reset(*a_pAddress);
+
+				std::uint64_t l_iTop = m_iFreeTop.load(std::memory_order_relaxed);
+
+				do
+				{
+					//Link the released object on top of the current top of the stack
+					m_pNextFree[i_slabIndex].store(static_cast<std::uint32_t>(l_iTop), std::memory_order_relaxed);
+				}
+				while (!m_iFreeTop.compare_exchange_weak(l_iTop, pack((l_iTop >> 32) + 1, static_cast<std::uint32_t>(i_slabIndex)), std::memory_order_release, std::memory_order_relaxed));
+			}
+
+
+			//Releases a_iCount objects back to the pool in one go. Safe to call from any thread
+			void releaseBulk(type** a_pAddresses, const int a_iCount)
+			{
+				//Let each object clear itself out before it goes back in the pool
+				for (int i = 0; i < a_iCount; i++)
+				{
+					if (owns(a_pAddresses[i])) PoolReset<type>::reset(*a_pAddresses[i]);
+				}
+
+				pushChain(a_pAddresses, a_iCount);
+			}
+
+
+			//Getter for size of pool
+			int size() const
+			{
+				return m_iSize;
+			}
+
+			//Returns true if the given address is one of the objects in this pool
+			bool owns(const type* a_pAddress) const
+			{
+				return slabIndex(a_pAddress) > -1;
+			}
+
+
+	};
+
+
+#endif
@@ -0,0 +1,217 @@
+/*
+	NovaCorps - DensePool.h
+
+	This header file describes the DensePool class.
+
+		A DensePool keeps its active objects packed together at the start of one contiguous,
+	cache-line aligned block of memory, so the active objects can be handed out as a single span and
+	processed with plain array loops or vector (SIMD) kernels.
+
+		Where a Pool or SlabPool swaps pointers on release, a DensePool swaps the objects themselves:
+	releasing an object moves the last active object into its place. This keeps the active half
+	dense, but it means addresses are not stable. After .release(object), that address holds what
+	used to be the last active object, and the last active object's old address is free. Only hold
+	on to addresses between releases, or use a Pool or SlabPool if you need them to stay put.
+
+	To run over the actives:
+
+		for (Particle& l_particle : pool.activeSpan())		//C++20
+		{
+			//code to be run on l_particle
+		}
+
+		pool.forEachActive([](Particle& a_particle) { ... });
+
+*/
+
+
+#ifndef DENSE_POOL_H
+
+	#define DENSE_POOL_H
+
+	#include <cstddef>
+	#include <cstdint>
+	#include <new>
+	#include <utility>
+
+	#if __cplusplus >= 202002L
+		#include <span>
+	#endif
+
+	#include "PoolTraits.h"
+
+	template <class type>
+	class DensePool
+	{
+		//Private members
+		private:
+
+			//Objects are aligned to at least a cache line, which also suits the widest vector loads
+			static constexpr std::size_t s_iAlignment = alignof(type) > 64 ? alignof(type) : 64;
+
+			//The Size of the pool [default 10]
+			int m_iSize = 10;
+
+			//Index of the first free object in the pool
+			int m_iNextFreePosition = 0;
+
+			//The single block of memory every object in the pool is constructed in, actives first
+			type* m_pSlab = nullptr;
+
+
+			//Returns the index in the slab of the given address, or -1 if it doesn't point to an object in this slab
+			int slabIndex(const type* a_pAddress) const
+			{
+				const std::uintptr_t l_iStart = reinterpret_cast<std::uintptr_t>(m_pSlab);
+				const std::uintptr_t l_iAddress = reinterpret_cast<std::uintptr_t>(a_pAddress);
+
+				if (l_iAddress < l_iStart || l_iAddress >= l_iStart + sizeof(type) * m_iSize) return -1;
+				if ((l_iAddress - l_iStart) % sizeof(type) != 0) return -1;
+
+				return static_cast<int>((l_iAddress - l_iStart) / sizeof(type));
+			}
+
+
+		//Public members
+		public:
+
+			//Creates a DensePool of a_size with default objects of given type
+			DensePool(const int a_iSize = 10)
+			{
+				if (a_iSize > 0)
+				{
+					m_iSize = a_iSize;
+					m_pSlab = static_cast<type*>(::operator new(sizeof(type) * a_iSize, std::align_val_t(s_iAlignment)));
+
+					for (int i = 0; i < a_iSize; i++)
+					{
+						new (m_pSlab + i) type();
+					}
+				}
+				else
+				{
+					//throw std::range_error(__FILE__ ": <DensePool Error>: Pool must have size greater than 0");
+					m_iSize = 0;
+				}
+			}
+
+			//The slab owns its objects outright, so a DensePool can't be copied
+			DensePool(const DensePool&) = delete;
+			DensePool& operator=(const DensePool&) = delete;
+
+			//Destructor
+			virtual ~DensePool()
+			{
+				for (int i = 0; i < m_iSize; i++)
+				{
+					m_pSlab[i].~type();
+				}
+
+				if (m_pSlab != nullptr) ::operator delete(m_pSlab, std::align_val_t(s_iAlignment));
+			}
+
+
+			//Retrieves the next object in the pool, or nullptr if there was nothing free
+			type* getNext()
+			{
+				if (m_iNextFreePosition < m_iSize)
+				{
+					return m_pSlab + m_iNextFreePosition++;
+				}
+				else
+				{
+					//throw std::overflow_error(__FILE__ ": <DensePool Error>: No available objects left in pool. Try releasing some objects");
+					return nullptr;
+				}
+			}
+
+			//Retrieves the next object in the pool and gives it a fresh value constructed from the given arguments (see PoolTraits.h)
+			template <class... args>
+			type* emplaceNext(args&&... a_args)
+			{
+				type* l_pObject = getNext();
+
+				if (l_pObject != nullptr) PoolReinitialise<type>::apply(l_pObject, std::forward<args>(a_args)...);
+
+				return l_pObject;
+			}
+
+
+			//Releases the object at the given address, moving the last active object into its place to keep the actives dense
+			void release(type* a_pAddress)
+			{
+				const int i_slabIndex = slabIndex(a_pAddress);
+
+				if (i_slabIndex > -1 && i_slabIndex < m_iNextFreePosition)
+				{
+					//Let the object clear itself out before it goes back in the pool
+					PoolReset<type>::reset(*a_pAddress);
+
+					const int lastActive = m_iNextFreePosition - 1;
+
+					if (i_slabIndex != lastActive)
+					{
+						using std::swap;
+						swap(m_pSlab[i_slabIndex], m_pSlab[lastActive]);
+					}
+
+					m_iNextFreePosition--;
+				}
+				else
+				{
+					//throw std::range_error(__FILE__ ": <DensePool Error>: Given Address was not found in active pool or was already inactive");
+				}
+			}
+
+
+			//Returns the first active object, with the number of them written to a_end. The actives follow it one after another
+			type* activeObjects(int* a_end)
+			{
+				if (a_end != nullptr) *a_end = m_iNextFreePosition;
+				return m_pSlab;
+			}
+
+		#if __cplusplus >= 202002L
+			//Returns the active objects as one contiguous span
+			std::span<type> activeSpan()
+			{
+				return std::span<type>(m_pSlab, static_cast<std::size_t>(m_iNextFreePosition));
+			}
+		#endif
+
+			//Calls a_function on each active object in turn. The function must not retrieve or release objects from this pool
+			template <class function>
+			void forEachActive(function a_function)
+			{
+				const int l_iEnd = m_iNextFreePosition;
+
+				for (int i = 0; i < l_iEnd; i++)
+				{
+					a_function(m_pSlab[i]);
+				}
+			}
+
+
+			//Getter for size of pool
+			int size() const
+			{
+				return m_iSize;
+			}
+
+			//Returns number of active elements in pool
+			int activeCount() const
+			{
+				return m_iNextFreePosition;
+			}
+
+			//Returns number of free elements in pool
+			int freeCount() const
+			{
+				return m_iSize - m_iNextFreePosition;
+			}
+
+
+	};
+
+
+#endif
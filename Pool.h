@@ -16,7 +16,20 @@
 	at runtime (a memory intensive process).
 	
 		Objects will not have default settings when they are retrieved, and will instead retain
-	whatever properties they had when last used.
+	whatever properties they had when last used. Use .emplaceNext(args...) to retrieve an object
+	with a fresh value built in place, or specialise PoolReset (see PoolTraits.h) to have objects
+	cleaned up as they are released.
+
+		Objects are default constructed unless the pool is made from an object to clone, a factory, or
+	a set of constructor arguments, so types without a default constructor, and move-only types, can
+	be pooled too:
+
+		Pool<Connection> pool(16, []() { return Connection(server); });
+		Pool<Socket> pool(16, PoolInPlace(), host, port);
+
+	Objects added when the pool grows are made the same way: default constructed, copied from the
+	last object in the pool, or built by the factory or from the arguments. Only pools made from an
+	object to clone ever copy.
 
 
 	To iterate through a pool's actives:
@@ -32,6 +45,10 @@
 			}
 		}
 
+	Or, more simply:
+
+		pool.forEachActive([](type& a_object) { ... });
+
 */
 
 
@@ -39,6 +56,27 @@
 
 	#define POOL_H
 
+	#include <climits>
+	#include <cstdint>
+	#include <functional>
+	#include <memory>
+	#include <mutex>
+	#include <unordered_map>
+	#include <utility>
+	#include <vector>
+
+	#include "PoolHandle.h"
+	#include "PoolScheduler.h"
+	#include "PoolTraits.h"
+
+	//Refers to an object in a Pool by its id and the generation it had when retrieved, so the reference can be checked
+	//for going stale (the object having been released, and possibly retrieved again since) without touching the object
+	struct PoolRef
+	{
+		std::uint32_t id;
+		std::uint32_t generation;
+	};
+
 	template <class type>
 	class Pool
 	{
@@ -52,7 +90,288 @@
 			int m_iNextFreePosition = 0;
 			
 			//Holds the pointer to the start of our array of pointers to objects in the pool
-			type** m_pArrayLocation;
+			type** m_pArrayLocation = nullptr;
+
+			//Maps the address of each object in the pool to its id, so release doesn't have to search the array for it
+			std::unordered_map<type*, int> m_mapObjectIds;
+
+			//Holds the id of the object at each position in our array, swapped alongside it so the two stay in step
+			int* m_pIds = nullptr;
+
+			//Number of positions our arrays have room for, which can run ahead of the size when the pool grows by itself
+			int m_iCapacity = 0;
+
+			//Holds the current position in our array of the object with each id. Ids with no object at the moment hold the
+			//next unused id instead, stored as -2 - id (so -1 marks the end), which threads a free list through them
+			int* m_pPositions = nullptr;
+
+			//Holds the generation of each id, bumped whenever its object is released or deleted so old PoolRefs can be spotted
+			std::uint32_t* m_pGenerations = nullptr;
+
+			//Number of ids handed out so far, and the number our id arrays have room for
+			int m_iIdCount = 0;
+			int m_iIdCapacity = 0;
+
+			//First unused id on the free list threaded through m_pPositions, or -1 if there are none.
+			//Ids of deleted objects are handed out again to new objects so ids stay close together
+			int m_iFreeId = -1;
+
+			//How much bigger the pool gets each time it runs out [default 0, meaning it never grows by itself]
+			float m_fGrowthFactor = 0.0f;
+
+			//The pool will never grow by itself beyond this size
+			int m_iMaxSize = INT_MAX;
+
+			//Number of times the pool has grown by itself
+			int m_iGrowthCount = 0;
+
+			//Fraction of the pool that must be free before it counts as idle, and the fraction left free after trimming
+			float m_fTrimHighWater = 1.0f;
+			float m_fTrimLowWater = 0.0f;
+
+			//Number of releases in a row the pool must stay idle before it trims itself [default 0, meaning it never trims by itself]
+			int m_iTrimWindow = 0;
+
+			//The pool will never trim itself below this size
+			int m_iMinSize = 1;
+
+			//Number of releases in a row the pool has been idle for
+			int m_iIdleReleases = 0;
+
+			//Number of times the pool has trimmed itself
+			int m_iTrimCount = 0;
+
+			//Set while parallelForEachActive is running, during which the active half mustn't change
+			bool m_bSweeping = false;
+
+			//Objects waiting to be released by flushReleases(), and the lock that lets several threads add to them at once
+			std::vector<type*> m_vPendingReleases;
+			mutable std::mutex m_pendingMutex;
+
+			//Sets the sweeping flag for as long as it exists, so the flag is cleared again even if the sweep throws
+			struct SweepGuard
+			{
+				bool& m_bSweeping;
+
+				SweepGuard(bool& a_bSweeping)
+					: m_bSweeping(a_bSweeping)
+				{
+					m_bSweeping = true;
+				}
+
+				~SweepGuard()
+				{
+					m_bSweeping = false;
+				}
+			};
+
+			//Creates each new object when the pool grows, given the last object in the pool before it started growing (or nullptr
+			//if it was empty). Pools made from a factory or constructor arguments use those; other pools copy the last object
+			std::function<type*(const type*)> m_fnCreate;
+
+
+			//Gives every object in the array an id and records where it currently sits. Only used when the pool is first created
+			void indexObjects()
+			{
+				m_pIds = new int[m_iSize];
+				m_iCapacity = m_iSize;
+
+				m_pPositions = new int[m_iSize];
+				m_pGenerations = new std::uint32_t[m_iSize];
+				m_iIdCount = m_iSize;
+				m_iIdCapacity = m_iSize;
+
+				m_mapObjectIds.reserve(m_iSize);
+
+				//An object's id starts out as its position, they only diverge once release starts swapping things around
+				for (int i = 0; i < m_iSize; i++)
+				{
+					m_mapObjectIds[m_pArrayLocation[i]] = i;
+					m_pPositions[i] = i;
+					m_pGenerations[i] = 0;
+					m_pIds[i] = i;
+				}
+			}
+
+			//Reallocates the arrays indexed by position to hold exactly a_iCapacity objects, which must be at least the size
+			void reallocatePositions(const int a_iCapacity)
+			{
+				type** l_pNewArray = new type*[a_iCapacity];
+				int* l_pNewIds = new int[a_iCapacity];
+
+				for (int i = 0; i < m_iSize; i++)
+				{
+					l_pNewArray[i] = m_pArrayLocation[i];
+					l_pNewIds[i] = m_pIds[i];
+				}
+
+				delete[] m_pArrayLocation;
+				delete[] m_pIds;
+
+				m_pArrayLocation = l_pNewArray;
+				m_pIds = l_pNewIds;
+				m_iCapacity = a_iCapacity;
+			}
+
+			//Makes sure the arrays indexed by position have room for a_iSize objects. Room is doubled when it runs out (but
+			//never past a_iLimit), so growing a little at a time, or growing back after shrinking, rarely copies the arrays
+			void reservePositions(const int a_iSize, const int a_iLimit)
+			{
+				if (a_iSize <= m_iCapacity) return;
+
+				long long l_iNewCapacity = 2LL * m_iCapacity;
+				if (l_iNewCapacity < a_iSize) l_iNewCapacity = a_iSize;
+				if (l_iNewCapacity > a_iLimit) l_iNewCapacity = a_iLimit;
+
+				reallocatePositions(static_cast<int>(l_iNewCapacity));
+			}
+
+			//Returns an id for a new object, reusing the id of a deleted object if there is one
+			int takeId()
+			{
+				if (m_iFreeId > -1)
+				{
+					const int l_iId = m_iFreeId;
+					m_iFreeId = -2 - m_pPositions[l_iId];
+					return l_iId;
+				}
+
+				//Out of ids, so make room for more. Room is doubled so this rarely happens
+				if (m_iIdCount == m_iIdCapacity)
+				{
+					const int l_iNewCapacity = m_iIdCapacity > 0 ? 2 * m_iIdCapacity : 16;
+
+					int* l_pNewPositions = new int[l_iNewCapacity];
+					std::uint32_t* l_pNewGenerations = new std::uint32_t[l_iNewCapacity];
+
+					for (int i = 0; i < m_iIdCount; i++)
+					{
+						l_pNewPositions[i] = m_pPositions[i];
+						l_pNewGenerations[i] = m_pGenerations[i];
+					}
+
+					delete[] m_pPositions;
+					delete[] m_pGenerations;
+
+					m_pPositions = l_pNewPositions;
+					m_pGenerations = l_pNewGenerations;
+					m_iIdCapacity = l_iNewCapacity;
+				}
+
+				m_pGenerations[m_iIdCount] = 0;
+				return m_iIdCount++;
+			}
+
+			//Adds the given object to the end of the pool, which must have room for it
+			void addObject(type* a_pObject)
+			{
+				const int l_iId = takeId();
+
+				m_pArrayLocation[m_iSize] = a_pObject;
+				m_pIds[m_iSize] = l_iId;
+				m_pPositions[l_iId] = m_iSize;
+				m_mapObjectIds[a_pObject] = l_iId;
+
+				m_iSize++;
+			}
+
+			//Deletes the object at the end of the pool and frees up its id
+			void removeLastObject()
+			{
+				m_iSize--;
+
+				type* l_pObject = m_pArrayLocation[m_iSize];
+				const int l_iId = m_pIds[m_iSize];
+
+				m_mapObjectIds.erase(l_pObject);
+				m_pGenerations[l_iId]++;
+
+				//Put the id on the front of the free list
+				m_pPositions[l_iId] = -2 - m_iFreeId;
+				m_iFreeId = l_iId;
+
+				delete l_pObject;
+			}
+
+			//Releases the object with the given id at the given position, which must be active
+			void releaseAt(const int a_iId, const int a_iPosition)
+			{
+				type* l_pAddress = m_pArrayLocation[a_iPosition];
+
+				//Let the object clear itself out before it goes back in the pool
+				PoolReset<type>::reset(*l_pAddress);
+
+				//Swap contents of this array address and last active array address. This sorts array into half active, half free
+				const int lastActive = m_iNextFreePosition - 1;
+				type* lastActiveAddress = m_pArrayLocation[lastActive];
+				m_pArrayLocation[lastActive] = l_pAddress;
+				m_pArrayLocation[a_iPosition] = lastActiveAddress;
+
+				//Swap their ids to match, and record where each object has moved to
+				const int lastActiveId = m_pIds[lastActive];
+				m_pIds[lastActive] = a_iId;
+				m_pIds[a_iPosition] = lastActiveId;
+				m_pPositions[a_iId] = lastActive;
+				m_pPositions[lastActiveId] = a_iPosition;
+
+				//Any PoolRef to the object from before now is stale
+				m_pGenerations[a_iId]++;
+
+				//Decrement the pointer to the next active object, which will point it to this newly released object as it is now first in the list of free objects
+				m_iNextFreePosition--;
+
+				checkTrim();
+			}
+
+			//Returns the position of the active object the given reference refers to, or -1 if the reference is stale
+			int positionOf(const PoolRef a_ref) const
+			{
+				if (a_ref.id >= static_cast<std::uint32_t>(m_iIdCount) || m_pGenerations[a_ref.id] != a_ref.generation) return -1;
+
+				const int l_iPosition = m_pPositions[a_ref.id];
+				return l_iPosition > -1 && l_iPosition < m_iNextFreePosition ? l_iPosition : -1;
+			}
+
+			//Keeps track of how long the pool has been idle for, and trims it once it has been idle long enough
+			void checkTrim()
+			{
+				if (m_iTrimWindow <= 0) return;
+
+				if (m_iSize - m_iNextFreePosition > m_iSize * m_fTrimHighWater)
+				{
+					if (++m_iIdleReleases >= m_iTrimWindow) trim();
+				}
+				else
+				{
+					m_iIdleReleases = 0;
+				}
+			}
+
+			//Adds a chunk of new objects to the end of the pool according to the growth policy, returns false if it isn't allowed to grow
+			bool grow()
+			{
+				if (m_fGrowthFactor <= 1.0f || m_iSize >= m_iMaxSize) return false;
+
+				//Grow by the growth factor, but always by at least one object and never past the maximum size
+				long long l_iNewSize = static_cast<long long>(m_iSize * m_fGrowthFactor);
+				if (l_iNewSize <= m_iSize) l_iNewSize = m_iSize + 1;
+				if (l_iNewSize > m_iMaxSize) l_iNewSize = m_iMaxSize;
+
+				//Only the arrays of pointers and ids are ever reallocated, the objects themselves stay where they are
+				reservePositions(static_cast<int>(l_iNewSize), m_iMaxSize);
+
+				//New objects are created the same way as when resizing with size(int)
+				const type* l_pLastOriginal = m_iSize > 0 ? m_pArrayLocation[m_iSize - 1] : nullptr;
+
+				while (m_iSize < l_iNewSize)
+				{
+					addObject(m_fnCreate(l_pLastOriginal));
+				}
+
+				m_iGrowthCount++;
+
+				return true;
+			}
 
 
 		//Public members
@@ -73,11 +392,19 @@
 					//Set the next pointer in our array of pointers (pool) to this pointer (pointing to a new blank object)
 					m_pArrayLocation[i] = l_pObject;
 				}
+
+				indexObjects();
+
+				//Objects added when the pool grows are default constructed like the rest, so the type needn't be copyable
+				m_fnCreate = [](const type*) { return new type(); };
 			}
 			
 			//Creates a Pool of a_size with default objects of given type
 			Pool(const int a_iSize)
 			{
+				//As above, set up even for an empty pool so it can still be sized up later
+				m_fnCreate = [](const type*) { return new type(); };
+
 				if (a_iSize > 0)
 				{
 					//Define size property
@@ -95,16 +422,18 @@
 						//Set the next pointer in our array of pointers (pool) to this pointer (pointing to a new blank object)
 						m_pArrayLocation[i] = l_pObject;
 					}
+
+					indexObjects();
 				}
 				else
 				{
 					//throw std::range_error(__FILE__ ": <Pool Error>: Pool must have size greater than 0");
-					delete this;
+					m_iSize = 0;
 				}
 			}
 			
 			//Creates a Pool of a_size classes cloned from the given class GameObject texture
-			Pool(type* a_pObjectToPool, const int a_iSize)
+			Pool(const type* a_pObjectToPool, const int a_iSize)
 			{
 				if (a_iSize > 0)
 				{
@@ -117,23 +446,129 @@
 					//Create clones of original object on the heap and reference a pointer to it in our pool array (which is also on the heap)
 					for (int i = 0; i < a_iSize; i++)
 					{
-						//Create an empty object and point to it
-						type* l_pClone = new type();
+						//Copy construct the clone straight from the original object, rather than building an empty one and overwriting it
+						m_pArrayLocation[i] = new type(*a_pObjectToPool);
+					}
 
-						//Set the contents of the clone pointer to the contents of the original object (thus cloning it)
-						*l_pClone = *a_pObjectToPool;
+					indexObjects();
 
-						//Set the next item in our array of pointers (pool) to this pointer (pointing to a clone of the object)
-						m_pArrayLocation[i] = l_pClone;
-					}
+					//Objects added when the pool grows are copies of the last object in the pool
+					m_fnCreate = [](const type* a_pLast) { return new type(*a_pLast); };
 				}
 				else
 				{
 					//throw std::range_error(__FILE__ ": <Pool Error>: Pool must have size greater than 0");
-					delete this;
+					m_iSize = 0;
+
+					//With no objects to copy yet, objects added when the pool is sized up are copies of the original, which we keep
+					//our own copy of as it may be gone by then
+					std::shared_ptr<const type> l_pOriginal = std::make_shared<type>(*a_pObjectToPool);
+					m_fnCreate = [l_pOriginal](const type*) { return new type(*l_pOriginal); };
 				}
 			}
 			
+			//Creates a Pool of a_size clones of the given object as above, but warms it up in parallel: the clones are copy
+			//constructed in chunks of a_iGrain across the scheduler's threads, which cuts start-up time for big pools of big
+			//objects roughly by the number of cores. The original is only read, and copying it must not throw
+			Pool(const type* a_pObjectToPool, const int a_iSize, PoolScheduler& a_scheduler, const int a_iGrain = 1024)
+			{
+				if (a_iSize > 0)
+				{
+					//Define size property
+					m_iSize = a_iSize;
+
+					//Create pool array on the heap so it can be deleted when pool is resized or deleted
+					m_pArrayLocation = new type*[a_iSize];
+
+					//Each thread fills in its own run of the array, so no locking is needed
+					type** l_pArray = m_pArrayLocation;
+					a_scheduler.parallelFor(0, a_iSize, a_iGrain, [l_pArray, a_pObjectToPool](int a_iBegin, int a_iEnd)
+					{
+						for (int i = a_iBegin; i < a_iEnd; i++)
+						{
+							l_pArray[i] = new type(*a_pObjectToPool);
+						}
+					});
+
+					indexObjects();
+
+					//Objects added when the pool grows are copies of the last object in the pool
+					m_fnCreate = [](const type* a_pLast) { return new type(*a_pLast); };
+				}
+				else
+				{
+					//throw std::range_error(__FILE__ ": <Pool Error>: Pool must have size greater than 0");
+					m_iSize = 0;
+
+					//As above, keep a copy of the original to make objects from when the pool is sized up
+					std::shared_ptr<const type> l_pOriginal = std::make_shared<type>(*a_pObjectToPool);
+					m_fnCreate = [l_pOriginal](const type*) { return new type(*l_pOriginal); };
+				}
+			}
+
+			//Creates a Pool of a_size objects, each created by calling a_factory, which must return a new object by value.
+			//The factory is also used to create objects when the pool grows, so the type needn't be default constructible or
+			//copyable: move-only types can be pooled this way. The factory itself may be move-only too
+			template <class factory, class = decltype(type(std::declval<factory&>()()))>
+			Pool(const int a_iSize, factory a_factory)
+			{
+				//Kept even for an empty pool, so it can still be sized up later. The factory is shared rather than copied into
+				//m_fnCreate, as std::function can only hold copyable callables
+				std::shared_ptr<factory> l_pFactory = std::make_shared<factory>(std::move(a_factory));
+				m_fnCreate = [l_pFactory](const type*) { return new type((*l_pFactory)()); };
+
+				if (a_iSize > 0)
+				{
+					//Define size property
+					m_iSize = a_iSize;
+
+					//Create pool array on the heap so it can be deleted when pool is resized or deleted
+					m_pArrayLocation = new type*[a_iSize];
+
+					for (int i = 0; i < a_iSize; i++)
+					{
+						m_pArrayLocation[i] = m_fnCreate(nullptr);
+					}
+
+					indexObjects();
+				}
+				else
+				{
+					//throw std::range_error(__FILE__ ": <Pool Error>: Pool must have size greater than 0");
+					m_iSize = 0;
+				}
+			}
+
+			//Creates a Pool of a_size objects, each constructed directly from copies of the given arguments. Tag the arguments
+			//with PoolInPlace, as in Pool<Socket>(16, PoolInPlace(), host, port). The arguments are kept for when the pool grows
+			template <class... args>
+			Pool(const int a_iSize, PoolInPlace, const args&... a_args)
+			{
+				//As above, kept even for an empty pool
+				m_fnCreate = [a_args...](const type*) { return new type(a_args...); };
+
+				if (a_iSize > 0)
+				{
+					//Define size property
+					m_iSize = a_iSize;
+
+					//Create pool array on the heap so it can be deleted when pool is resized or deleted
+					m_pArrayLocation = new type*[a_iSize];
+
+					for (int i = 0; i < a_iSize; i++)
+					{
+						m_pArrayLocation[i] = m_fnCreate(nullptr);
+					}
+
+					indexObjects();
+				}
+				else
+				{
+					//throw std::range_error(__FILE__ ": <Pool Error>: Pool must have size greater than 0");
+					m_iSize = 0;
+				}
+			}
+
 			//Destructor
 			virtual ~Pool()
 			{
@@ -142,15 +577,18 @@
 				{
 					delete m_pArrayLocation[i_pointer];
 				}
-				delete m_pArrayLocation;
+				delete[] m_pArrayLocation;
+				delete[] m_pIds;
+				delete[] m_pPositions;
+				delete[] m_pGenerations;
 			}
 
 
 			//Retrieves the next object in the pool
 			type* getNext()
 			{
-				//If we have something free
-				if (m_iNextFreePosition < m_iSize)
+				//If we have something free, or can make something free by growing (but not while the actives are being swept)
+				if (!m_bSweeping && (m_iNextFreePosition < m_iSize || grow()))
 				{
 					//Get address of object located at next pointer
 					const int i_positionPointer = m_iNextFreePosition;
@@ -169,110 +607,289 @@
 			}
 
 
+			//Retrieves the next object in the pool wrapped in a handle that releases it when the handle is destroyed.
+			//The handle is empty if there was nothing free.
+			PoolHandle<type> acquire()
+			{
+				return PoolHandle<type>(getNext(), this);
+			}
+
+
+			//Retrieves the next object in the pool and gives it a fresh value constructed from the given arguments, in place where possible
+			//(see PoolTraits.h). Returns nullptr if there was nothing free.
+			template <class... args>
+			type* emplaceNext(args&&... a_args)
+			{
+				type* l_pObject = getNext();
+
+				if (l_pObject != nullptr) PoolReinitialise<type>::apply(l_pObject, std::forward<args>(a_args)...);
+
+				return l_pObject;
+			}
+
+			//As emplaceNext, but wraps the object in a handle that releases it when the handle is destroyed.
+			template <class arg, class... args>
+			PoolHandle<type> acquire(arg&& a_arg, args&&... a_args)
+			{
+				return PoolHandle<type>(emplaceNext(std::forward<arg>(a_arg), std::forward<args>(a_args)...), this);
+			}
+
+
+			//Retrieves the next object in the pool and returns a reference to it instead of its address.
+			//The reference is invalid (see isValid) if there was nothing free
+			PoolRef getNextRef()
+			{
+				if (getNext() == nullptr) return PoolRef{ UINT32_MAX, 0 };
+
+				//The object we just retrieved is the last active one
+				const int l_iId = m_pIds[m_iNextFreePosition - 1];
+				return PoolRef{ static_cast<std::uint32_t>(l_iId), m_pGenerations[l_iId] };
+			}
+
+			//Returns a reference to the active object at the given address, which is invalid if the object isn't active
+			PoolRef refOf(type* a_pAddress) const
+			{
+				auto l_itId = m_mapObjectIds.find(a_pAddress);
+
+				if (l_itId == m_mapObjectIds.end() || m_pPositions[l_itId->second] >= m_iNextFreePosition) return PoolRef{ UINT32_MAX, 0 };
+
+				return PoolRef{ static_cast<std::uint32_t>(l_itId->second), m_pGenerations[l_itId->second] };
+			}
+
+			//Returns the object the given reference refers to, or nullptr if it has been released since the reference was made
+			type* get(const PoolRef a_ref) const
+			{
+				const int l_iPosition = positionOf(a_ref);
+				return l_iPosition > -1 ? m_pArrayLocation[l_iPosition] : nullptr;
+			}
+
+			//Returns true if the given reference still refers to an active object
+			bool isValid(const PoolRef a_ref) const
+			{
+				return positionOf(a_ref) > -1;
+			}
+
+
+			//Retrieves up to a_iCount objects in one go, writing them to a_pOut, and returns how many were retrieved
+			int getNext(const int a_iCount, type** a_pOut)
+			{
+				if (m_bSweeping) return 0;
+
+				//Grow until there are enough free, if we're allowed to
+				while (m_iSize - m_iNextFreePosition < a_iCount && grow());
+
+				//Take as many as were asked for, or as many as are free if that's fewer
+				int l_iTaken = a_iCount < m_iSize - m_iNextFreePosition ? a_iCount : m_iSize - m_iNextFreePosition;
+				if (l_iTaken < 0) l_iTaken = 0;
+
+				for (int i = 0; i < l_iTaken; i++)
+				{
+					a_pOut[i] = m_pArrayLocation[m_iNextFreePosition + i];
+				}
+
+				//Move the pointer past all of them at once
+				m_iNextFreePosition += l_iTaken;
+
+				return l_iTaken;
+			}
+
+
 			//Releases the object at the given address from use and internally resorts the pool to keep active and free in separate halves
 			void release(type* a_pAddress)
 			{
-				//To hold the position of the given address in the array, if and when we find it
+				//To hold the id and position of the given address in the array, if and when we find it
+				int i_addressId = -1;
 				int i_addressPositionInArray = -1;
 
-				//Loop from start to finish to find location of this address in the array
-				for (int i_location = 0; i_location < m_iSize; i_location++)
+				//Look up the id of this address, which tells us where it currently is in the array without searching
+				auto l_itId = m_mapObjectIds.find(a_pAddress);
+				if (l_itId != m_mapObjectIds.end())
 				{
-					if (m_pArrayLocation[i_location] == a_pAddress)
-					{
-						i_addressPositionInArray = i_location;
-						break;
-					}
+					i_addressId = l_itId->second;
+					i_addressPositionInArray = m_pPositions[i_addressId];
 				}
 
 				//If found then sort array, otherwise throw an exception
-				if (i_addressPositionInArray > -1 && i_addressPositionInArray < m_iNextFreePosition)
-				{					
-					//Make sure where we're slotting the released object into is valid
-					int lastActive = m_iNextFreePosition - 1;
-					if (lastActive < 0)
-					{
-						//throw std::range_error(__FILE__ ": <Pool Error>: Released object can never be out of pool scope");
-					}
+				//Active objects can't be released while the actives are being swept, as that would reorder them
+				if (!m_bSweeping && i_addressPositionInArray > -1 && i_addressPositionInArray < m_iNextFreePosition)
+				{
+					releaseAt(i_addressId, i_addressPositionInArray);
+				}
+				else
+				{
+					//throw std::range_error(__FILE__ ": <Pool Error>: Given Address was not found in active pool or was already inactive");
+				}
+			}
 
-					//Swap contents of this array address and last active array address. This sorts array into half active, half free
-					type* lastActiveAddress = m_pArrayLocation[lastActive];
-					m_pArrayLocation[lastActive] = a_pAddress;
-					m_pArrayLocation[i_addressPositionInArray] = lastActiveAddress;
 
-					//Decrement the pointer to the next active object, which will point it to this newly released object as it is now first in the list of free objects
-					m_iNextFreePosition--;
+			//Releases the object the given reference refers to, without looking up its address. Stale references are ignored,
+			//so releasing through a reference twice is harmless
+			void release(const PoolRef a_ref)
+			{
+				const int i_addressPositionInArray = positionOf(a_ref);
 
+				if (!m_bSweeping && i_addressPositionInArray > -1)
+				{
+					releaseAt(static_cast<int>(a_ref.id), i_addressPositionInArray);
 				}
 				else
 				{
-					//throw std::range_error(__FILE__ ": <Pool Error>: Given Address was not found in active pool or was already inactive");
+					//throw std::range_error(__FILE__ ": <Pool Error>: Given reference is stale");
 				}
 			}
 
 
+			//Releases a_iCount objects in one pass, each swapped out of the active half as with release()
+			void releaseBulk(type** a_pAddresses, const int a_iCount)
+			{
+				for (int i = 0; i < a_iCount; i++)
+				{
+					release(a_pAddresses[i]);
+				}
+			}
+
+
+			//Marks the object at the given address to be released at the next flushReleases(), leaving the active half untouched
+			//until then. Safe to call from several threads at once, such as from inside a parallelForEachActive callback
+			void releaseDeferred(type* a_pAddress)
+			{
+				std::lock_guard<std::mutex> l_lock(m_pendingMutex);
+				m_vPendingReleases.push_back(a_pAddress);
+			}
+
+			//Releases every object marked with releaseDeferred, in one pass over them. Does nothing while
+			//parallelForEachActive is running, so the marked objects wait for the next flush after it
+			void flushReleases()
+			{
+				if (m_bSweeping) return;
+
+				std::lock_guard<std::mutex> l_lock(m_pendingMutex);
+
+				if (m_vPendingReleases.empty()) return;
+
+				releaseBulk(m_vPendingReleases.data(), static_cast<int>(m_vPendingReleases.size()));
+				m_vPendingReleases.clear();
+			}
+
+			//Returns number of objects waiting to be released by flushReleases()
+			int pendingReleaseCount() const
+			{
+				std::lock_guard<std::mutex> l_lock(m_pendingMutex);
+				return static_cast<int>(m_vPendingReleases.size());
+			}
+
+
 			//Getter for size of Pool
 			int size() const
 			{
 				return m_iSize;
 			}
 
-			//Setter for size of pool, returns true if a new array could be created (valid size) and false if it couldn't
+			//Setter for size of pool, returns true if the size was valid and false if it wasn't. Active objects are never deleted:
+			//the pool only shrinks as far as the number of active objects, and existing objects never move, whichever way it goes
 			bool size(int a_iNewSize)
 			{
-				if (a_iNewSize > 0)
+				if (a_iNewSize > 0 && !m_bSweeping)
 				{
-					//create new array of a_newSize
-					type** l_pNewArray = new type*[a_iNewSize];
-
-					//more efficient at runtime to have these as a separate loops rather than make a longer loop with if statements inside
-
-					//add elements from start of existing array to new array, up to a_newSize
-					for (int i = 0; i < a_iNewSize && i < m_iSize; i++)
-					{
-						l_pNewArray[i] = m_pArrayLocation[i];
-					}
+					//Only free objects can be deleted, and they all sit after the active ones
+					if (a_iNewSize < m_iNextFreePosition) a_iNewSize = m_iNextFreePosition;
 
 					//operates if a_iNewSize > m_iSize
-					//fill remaining elements if there are any (a_newSize-oldSize) to the rest, as a clone of the last original element
-					for (int i = m_iSize; i < a_iNewSize; i++)
+					//fill remaining elements if there are any (a_newSize-oldSize) to the rest, made the same way the pool made its
+					//objects: default constructed, from its factory or constructor arguments, or as a copy of the last original element.
+					//The arrays are only reallocated when they run out of room, not every time
+					if (a_iNewSize > m_iSize)
 					{
-						//Create an empty object and point to it
-						type* l_pClone = new type();
+						reservePositions(a_iNewSize, INT_MAX);
 
-						//Set the contents of the clone pointer to the contents of the last original object
-						*l_pClone = *m_pArrayLocation[m_iSize-1];
+						const type* l_pLastOriginal = m_iSize > 0 ? m_pArrayLocation[m_iSize - 1] : nullptr;
 
-						//Set the next item in our array of pointers (pool) to this pointer (pointing to a clone of the object)
-						l_pNewArray[i] = l_pClone;
+						while (m_iSize < a_iNewSize)
+						{
+							addObject(m_fnCreate(l_pLastOriginal));
+						}
 					}
 
 					//operates if a_iNewSize < m_iSize
-					//delete hanging elements if there are any
-					for (int i = a_iNewSize; i < m_iSize; i++)
+					//delete free elements off the end. The arrays keep their room, so growing back again costs no reallocation
+					else if (a_iNewSize < m_iSize)
 					{
-						delete m_pArrayLocation[i];
+						while (m_iSize > a_iNewSize)
+						{
+							removeLastObject();
+						}
 					}
 
-					//delete old array
-					delete m_pArrayLocation;
+					return true;
+
+				}
+
+				//throw std::range_error(__FILE__ ": <Pool Error>: Pool must have size greater than 0");
+				return false;
 
-					//set array pointer to point to this new array
-					m_pArrayLocation = l_pNewArray;
+			}
 
-					//Set next item pointer to end of array if array is smaller than the pointer
-					if (m_iNextFreePosition > a_iNewSize) m_iNextFreePosition = a_iNewSize;
 
-					//redefine size property
-					m_iSize = a_iNewSize;
+			//Sets how the pool grows by itself when getNext finds nothing free: by a_fGrowthFactor times its current size
+			//(at least one object), up to a_iMaxSize objects. A growth factor of 1 or less turns growing off
+			void setGrowth(const float a_fGrowthFactor, const int a_iMaxSize = INT_MAX)
+			{
+				m_fGrowthFactor = a_fGrowthFactor;
+				m_iMaxSize = a_iMaxSize;
+			}
 
-					return true;
+			//Returns number of times the pool has grown by itself, useful for choosing a better starting size
+			int growthCount() const
+			{
+				return m_iGrowthCount;
+			}
+
+
+			//Sets how the pool trims itself when it sits mostly unused: once more than a_fHighWater of the pool has been
+			//free for a_iWindow releases in a row, free objects are deleted until only a_fLowWater of the pool is free, but
+			//never below a_iMinSize objects. Keeping a_fLowWater below a_fHighWater stops it trimming again straight away.
+			//A window of 0 turns trimming off
+			void setTrim(const float a_fHighWater, const float a_fLowWater, const int a_iWindow, const int a_iMinSize = 1)
+			{
+				m_fTrimHighWater = a_fHighWater;
+				m_fTrimLowWater = a_fLowWater < a_fHighWater ? a_fLowWater : a_fHighWater;
+				m_iTrimWindow = a_iWindow;
+				m_iMinSize = a_iMinSize > 1 ? a_iMinSize : 1;
+				m_iIdleReleases = 0;
+			}
+
+			//Deletes free objects until only the trim low water fraction of the pool is free. Active objects are never touched.
+			//Returns true if any objects were deleted
+			bool trim()
+			{
+				if (m_bSweeping) return false;
+
+				m_iIdleReleases = 0;
+
+				//Work out the size at which a_fLowWater of the pool is free, staying clear of the active half and the minimum size
+				const float l_fKeptFraction = 1.0f - m_fTrimLowWater;
+				long long l_iNewSize = l_fKeptFraction > 0.0f ? static_cast<long long>(m_iNextFreePosition / l_fKeptFraction) : m_iSize;
+				if (l_iNewSize < m_iNextFreePosition) l_iNewSize = m_iNextFreePosition;
+				if (l_iNewSize < m_iMinSize) l_iNewSize = m_iMinSize;
+				if (l_iNewSize >= m_iSize) return false;
 
+				//Everything from the new size onwards is in the free half, so it's safe to delete
+				while (m_iSize > l_iNewSize)
+				{
+					removeLastObject();
 				}
 
-				//throw std::range_error(__FILE__ ": <Pool Error>: Pool must have size greater than 0");
-				return false;
+				reallocatePositions(m_iSize);
+
+				m_iTrimCount++;
+
+				return true;
+			}
 
+			//Returns number of times the pool has trimmed itself
+			int trimCount() const
+			{
+				return m_iTrimCount;
 			}
 
 
@@ -298,8 +915,83 @@
 			}
 
 
+			//Returns the slot of the object at the given address, or -1 if it isn't in the pool. An object keeps the same slot for
+			//as long as it's in the pool, whether active or free, so slots can be used to index side tables that live alongside
+			//the pool. Slots run from 0 to slotCount() - 1, and a deleted object's slot is reused by the next object created
+			int slotOf(type* a_pAddress) const
+			{
+				auto l_itId = m_mapObjectIds.find(a_pAddress);
+				return l_itId != m_mapObjectIds.end() ? l_itId->second : -1;
+			}
+
+			//Returns the object in the given slot, active or free, or nullptr if the slot is unused
+			type* atSlot(const int a_iSlot) const
+			{
+				if (a_iSlot < 0 || a_iSlot >= m_iIdCount || m_pPositions[a_iSlot] < 0) return nullptr;
+				return m_pArrayLocation[m_pPositions[a_iSlot]];
+			}
+
+			//Returns true if the object in the given slot is active
+			bool isSlotActive(const int a_iSlot) const
+			{
+				return a_iSlot > -1 && a_iSlot < m_iIdCount && m_pPositions[a_iSlot] > -1 && m_pPositions[a_iSlot] < m_iNextFreePosition;
+			}
+
+			//Returns the number of slots in use or on the free list, which is the size side tables need to be
+			int slotCount() const
+			{
+				return m_iIdCount;
+			}
+
+			//Returns pointer to an array of the slots of all active objects, in the same order as activeAddresses(), with the
+			//number of them written to a_end. This is the dense index to iterate when working with side tables
+			const int* activeSlots(int* a_end) const
+			{
+				if (a_end != nullptr) *a_end = m_iNextFreePosition;
+				return m_pIds;
+			}
+
+
+			//Calls a_function on each active object in turn. The function must not retrieve or release objects from this pool
+			template <class function>
+			void forEachActive(function a_function)
+			{
+				const int l_iEnd = m_iNextFreePosition;
+
+				for (int i = 0; i < l_iEnd; i++)
+				{
+					a_function(*m_pArrayLocation[i]);
+				}
+			}
+
+
+			//Calls a_function on each active object, split into chunks of a_iGrain objects that are run in parallel by the
+			//given scheduler (see PoolScheduler.h). Returns once every object has been visited. While it runs the active half
+			//is frozen: getNext returns nullptr, and release, size and trim do nothing, so a_function must not rely on them.
+			//If a_function throws, the rest of the objects are skipped and the exception is passed on once the sweep has
+			//stopped, with the pool unfrozen. a_function must not start a parallel loop on the same scheduler, such as
+			//calling parallelForEachActive on another pool when both use the default PoolScheduler::shared(): that waits
+			//forever for this loop to finish
+			template <class function>
+			void parallelForEachActive(function a_function, const int a_iGrain = 1024, PoolScheduler& a_scheduler = PoolScheduler::shared())
+			{
+				SweepGuard l_sweep(m_bSweeping);
+
+				type** l_pActives = m_pArrayLocation;
+
+				a_scheduler.parallelFor(0, m_iNextFreePosition, a_iGrain, [&a_function, l_pActives](int a_iBegin, int a_iEnd)
+				{
+					for (int i = a_iBegin; i < a_iEnd; i++)
+					{
+						a_function(*l_pActives[i]);
+					}
+				});
+			}
+
+
 			//Returns pointer to an array of addresses of all active elements in pool.
 			//Useful if you've forgotten some things that need to be released.
+			//The array is reallocated if the pool grows or trims, so fetch it again after calling getNext or release on such a pool.
 			type** activeAddresses(int* a_end)
 			{
 				//Rather than make a new array and point to it, simply return a pointer to our array but with an end stop
@@ -0,0 +1,133 @@
+/*
+	NovaCorps - PoolAllocator.h
+
+	This header file describes the PoolAllocator class.
+
+		A PoolAllocator hands out raw memory for objects of any size, from a set of BlockPools (see
+	BlockPool.h), one for each power of two from 8 to 4096 bytes. Each request is served by the
+	smallest block size that fits it, so lots of small objects of different types share a handful
+	of warm, tightly packed pools rather than scattering across the heap, and both allocating and
+	deallocating are O(1).
+
+		Blocks of each size are aligned to that size, so any alignment up to the block size is met.
+	Requests bigger than 4096 bytes, or aligned more strictly than their size class, go straight to
+	the system allocator.
+
+		As with sized delete, deallocate must be given the same size and alignment that were passed
+	to allocate. A PoolAllocator is not thread-safe.
+
+	For example:
+
+		PoolAllocator allocator;
+
+		void* l_pMemory = allocator.allocate(sizeof(Particle), alignof(Particle));
+		Particle* l_pParticle = new (l_pMemory) Particle();
+		...
+		l_pParticle->~Particle();
+		allocator.deallocate(l_pParticle, sizeof(Particle), alignof(Particle));
+
+*/
+
+
+#ifndef POOL_ALLOCATOR_H
+
+	#define POOL_ALLOCATOR_H
+
+	#include <cstddef>
+	#include <memory>
+	#include <new>
+
+	#include "BlockPool.h"
+
+	class PoolAllocator
+	{
+		//Private members
+		private:
+
+			//The smallest and largest block sizes, and how many sizes there are in between (powers of two, inclusive)
+			static constexpr std::size_t s_iMinBlockSize = 8;
+			static constexpr std::size_t s_iMaxBlockSize = 4096;
+			static constexpr int s_iSizeClasses = 10;
+
+			//One pool of blocks for each size class, smallest first
+			std::unique_ptr<BlockPool> m_pBuckets[s_iSizeClasses];
+
+
+			//Returns which size class serves a request, or -1 if it's too big for any of them
+			static int sizeClass(const std::size_t a_iBytes, const std::size_t a_iAlignment)
+			{
+				std::size_t l_iNeeded = a_iBytes > a_iAlignment ? a_iBytes : a_iAlignment;
+				std::size_t l_iBlockSize = s_iMinBlockSize;
+
+				for (int i = 0; i < s_iSizeClasses; i++, l_iBlockSize *= 2)
+				{
+					if (l_iNeeded <= l_iBlockSize) return i;
+				}
+
+				return -1;
+			}
+
+
+		//Public members
+		public:
+
+			//Creates an allocator whose pools each grow a chunk of about a_iChunkBytes at a time [default 64KB]
+			explicit PoolAllocator(const std::size_t a_iChunkBytes = 64 * 1024)
+			{
+				std::size_t l_iBlockSize = s_iMinBlockSize;
+
+				for (int i = 0; i < s_iSizeClasses; i++, l_iBlockSize *= 2)
+				{
+					const std::size_t l_iBlocks = a_iChunkBytes / l_iBlockSize;
+					m_pBuckets[i].reset(new BlockPool(l_iBlockSize, l_iBlocks > 16 ? static_cast<int>(l_iBlocks) : 16, l_iBlockSize));
+				}
+			}
+
+			//The allocator owns its pools outright, so it can't be copied
+			PoolAllocator(const PoolAllocator&) = delete;
+			PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+
+			//Returns memory for a_iBytes bytes aligned to a_iAlignment (a power of two). Throws std::bad_alloc if out of memory
+			void* allocate(const std::size_t a_iBytes, const std::size_t a_iAlignment = alignof(std::max_align_t))
+			{
+				const int l_iClass = sizeClass(a_iBytes, a_iAlignment);
+
+				if (l_iClass < 0) return ::operator new(a_iBytes, std::align_val_t(a_iAlignment));
+
+				void* l_pBlock = m_pBuckets[l_iClass]->allocate();
+				if (l_pBlock == nullptr) throw std::bad_alloc();
+
+				return l_pBlock;
+			}
+
+			//Gives back memory from allocate, which must be passed the same size and alignment it was allocated with
+			void deallocate(void* a_pMemory, const std::size_t a_iBytes, const std::size_t a_iAlignment = alignof(std::max_align_t))
+			{
+				if (a_pMemory == nullptr) return;
+
+				const int l_iClass = sizeClass(a_iBytes, a_iAlignment);
+
+				if (l_iClass < 0) ::operator delete(a_pMemory, std::align_val_t(a_iAlignment));
+				else m_pBuckets[l_iClass]->deallocate(a_pMemory);
+			}
+
+
+			//Returns the pool of blocks that serves requests of the given size and alignment, or nullptr if they go to the system
+			const BlockPool* bucketFor(const std::size_t a_iBytes, const std::size_t a_iAlignment = alignof(std::max_align_t)) const
+			{
+				const int l_iClass = sizeClass(a_iBytes, a_iAlignment);
+				return l_iClass < 0 ? nullptr : m_pBuckets[l_iClass].get();
+			}
+
+			//Getter for the largest request served from the pools
+			static constexpr std::size_t maxBlockSize()
+			{
+				return s_iMaxBlockSize;
+			}
+
+
+	};
+
+
+#endif
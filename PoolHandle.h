@@ -0,0 +1,138 @@
+/*
+	NovaCorps - PoolHandle.h
+
+	This header file describes the PoolHandle class.
+
+		A PoolHandle holds an object retrieved from a pool and releases it back to that pool when the
+	handle goes out of scope, so an object can't be forgotten about and left active forever. Handles
+	are returned by .acquire() on any of the pools.
+
+		A handle can be moved but not copied, so there is only ever one owner of the object and no
+	reference counting. It holds nothing but the object's address and the pool's, and every member
+	is a trivial inline forward, so in an optimised build using a handle costs the same as using the
+	raw pointer and calling .release() yourself.
+
+	For example:
+
+		{
+			auto l_bullet = pool.acquire();
+
+			if (l_bullet)
+			{
+				l_bullet->fire();
+			}
+
+		} //Bullet released back to the pool here
+
+*/
+
+
+#ifndef POOL_HANDLE_H
+
+	#define POOL_HANDLE_H
+
+	template <class type>
+	class Pool;
+
+	template <class type, class pool = Pool<type>>
+	class PoolHandle
+	{
+		//Private members
+		private:
+
+			//The object this handle owns, or nullptr if it owns nothing
+			type* m_pObject = nullptr;
+
+			//The pool the object goes back to
+			pool* m_pPool = nullptr;
+
+
+		//Public members
+		public:
+
+			//Creates a handle that owns nothing
+			PoolHandle() noexcept = default;
+
+			//Creates a handle that owns the given object, which will be released to the given pool
+			PoolHandle(type* a_pObject, pool* a_pPool) noexcept
+				: m_pObject(a_pObject), m_pPool(a_pPool)
+			{
+			}
+
+			//Takes ownership of the object held by another handle, leaving that handle empty
+			PoolHandle(PoolHandle&& a_other) noexcept
+				: m_pObject(a_other.m_pObject), m_pPool(a_other.m_pPool)
+			{
+				a_other.m_pObject = nullptr;
+			}
+
+			//Releases whatever this handle owned, then takes ownership of the object held by another handle
+			PoolHandle& operator=(PoolHandle&& a_other) noexcept
+			{
+				if (this != &a_other)
+				{
+					reset();
+					m_pObject = a_other.m_pObject;
+					m_pPool = a_other.m_pPool;
+					a_other.m_pObject = nullptr;
+				}
+				return *this;
+			}
+
+			//There can only be one owner, so handles can't be copied
+			PoolHandle(const PoolHandle&) = delete;
+			PoolHandle& operator=(const PoolHandle&) = delete;
+
+			//Destructor. Releases the object back to its pool
+			~PoolHandle()
+			{
+				reset();
+			}
+
+
+			//Releases the object back to its pool now, leaving the handle empty
+			void reset()
+			{
+				if (m_pObject != nullptr)
+				{
+					m_pPool->release(m_pObject);
+					m_pObject = nullptr;
+				}
+			}
+
+			//Gives up ownership of the object without releasing it, and returns it. It must then be released by hand
+			type* detach() noexcept
+			{
+				type* l_pObject = m_pObject;
+				m_pObject = nullptr;
+				return l_pObject;
+			}
+
+
+			//Returns the object this handle owns, or nullptr if it owns nothing
+			type* get() const noexcept
+			{
+				return m_pObject;
+			}
+
+			type& operator*() const noexcept
+			{
+				return *m_pObject;
+			}
+
+			type* operator->() const noexcept
+			{
+				return m_pObject;
+			}
+
+			//True if the handle owns an object. Check this after acquiring, as an exhausted pool gives back an empty handle
+			explicit operator bool() const noexcept
+			{
+				return m_pObject != nullptr;
+			}
+
+
+	};
+
+
+#endif
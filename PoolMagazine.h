@@ -0,0 +1,207 @@
+/*
+	NovaCorps - PoolMagazine.h
+
+	This header file describes the PoolMagazine class.
+
+		A PoolMagazine is a small stack of free objects that belongs to a single thread and sits in
+	front of a shared ConcurrentPool (see ConcurrentPool.h). Calling .getNext() and .release(object)
+	on the magazine only touches that stack, so threads working from their own magazines don't fight
+	over the pool's shared cache lines.
+
+		When the magazine runs dry it refills itself with a batch of objects from the pool, and when it
+	fills up it flushes a batch back, each with a single operation on the pool. Refilling and
+	flushing only go halfway, so a thread that alternates between retrieving and releasing doesn't
+	bounce off the pool on every call. How often each happens can be read from .refillCount() and
+	.flushCount(), which is useful when choosing a magazine size.
+
+		A magazine is not thread-safe itself; give each thread its own. Any objects still in the
+	magazine are returned to the pool when it is destroyed, so the pool must outlive it.
+
+	To give every thread a magazine of 64 objects:
+
+		thread_local PoolMagazine<Bullet> t_bullets(g_bulletPool, 64);
+
+		Bullet* l_pBullet = t_bullets.getNext();
+		...
+		t_bullets.release(l_pBullet);
+
+*/
+
+
+#ifndef POOL_MAGAZINE_H
+
+	#define POOL_MAGAZINE_H
+
+	#include "ConcurrentPool.h"
+
+	template <class type>
+	class PoolMagazine
+	{
+		//Private members
+		private:
+
+			//The shared pool this magazine refills from and flushes to
+			ConcurrentPool<type>* m_pPool;
+
+			//The most objects the magazine will hold [default 32]
+			int m_iCapacity = 32;
+
+			//Number of objects currently in the magazine
+			int m_iCount = 0;
+
+			//Holds the objects in the magazine, the most recently released on top
+			type** m_pObjects;
+
+			//Number of times the magazine has had to refill from or flush to the pool
+			long long m_iRefills = 0;
+			long long m_iFlushes = 0;
+
+
+			//How many objects a refill or flush moves in one go
+			int batchSize() const
+			{
+				return m_iCapacity > 1 ? m_iCapacity / 2 : 1;
+			}
+
+
+		//Public members
+		public:
+
+			//Creates a magazine holding up to a_iCapacity objects from the given pool
+			PoolMagazine(ConcurrentPool<type>& a_pool, const int a_iCapacity = 32)
+				: m_pPool(&a_pool), m_iCapacity(a_iCapacity > 0 ? a_iCapacity : 1)
+			{
+				m_pObjects = new type*[m_iCapacity];
+			}
+
+			//A magazine holds objects on behalf of one thread, so it can't be copied
+			PoolMagazine(const PoolMagazine&) = delete;
+			PoolMagazine& operator=(const PoolMagazine&) = delete;
+
+			//Destructor. Hands any objects still in the magazine back to the pool
+			virtual ~PoolMagazine()
+			{
+				flush();
+				delete[] m_pObjects;
+			}
+
+
+			//Retrieves the next object, refilling the magazine from the pool if it's empty. Returns nullptr if the pool is exhausted too
+			type* getNext()
+			{
+				if (m_iCount == 0)
+				{
+					m_iCount = m_pPool->getNext(batchSize(), m_pObjects);
+					m_iRefills++;
+
+					if (m_iCount == 0)
+					{
+						//throw std::overflow_error(__FILE__ ": <PoolMagazine Error>: No available objects left in pool. Try releasing some objects");
+						return nullptr;
+					}
+				}
+
+				return m_pObjects[--m_iCount];
+			}
+
+
+			//Retrieves the next object in the pool wrapped in a handle that releases it when the handle is destroyed.
+			//The handle is empty if there was nothing free.
+			PoolHandle<type, PoolMagazine<type>> acquire()
+			{
+				return PoolHandle<type, PoolMagazine<type>>(getNext(), this);
+			}
+
+
+			//Retrieves the next object and gives it a fresh value constructed from the given arguments, in place where possible
+			//(see PoolTraits.h). Returns nullptr if there was nothing free
+			template <class... args>
+			type* emplaceNext(args&&... a_args)
+			{
+				type* l_pObject = getNext();
+
+				if (l_pObject != nullptr) PoolReinitialise<type>::apply(l_pObject, std::forward<args>(a_args)...);
+
+				return l_pObject;
+			}
+
+			//As emplaceNext, but wraps the object in a handle that releases it when the handle is destroyed
+			template <class arg, class... args>
+			PoolHandle<type, PoolMagazine<type>> acquire(arg&& a_arg, args&&... a_args)
+			{
+				return PoolHandle<type, PoolMagazine<type>>(emplaceNext(std::forward<arg>(a_arg), std::forward<args>(a_args)...), this);
+			}
+
+
+			//Releases the object at the given address into the magazine, flushing a batch to the pool first if the magazine is full
+			void release(type* a_pAddress)
+			{
+				if (!m_pPool->owns(a_pAddress))
+				{
+					//throw std::range_error(__FILE__ ": <PoolMagazine Error>: Given Address was not found in pool");
+					return;
+				}
+
+				//Let the object clear itself out before it goes back in the magazine
+				PoolReset<type>::reset(*a_pAddress);
+
+				if (m_iCount == m_iCapacity)
+				{
+					//Flush the objects at the bottom of the magazine, as the ones on top are the most recently used and likely still in cache
+					const int l_iBatch = batchSize();
+					m_pPool->pushChain(m_pObjects, l_iBatch);
+
+					m_iCount -= l_iBatch;
+					for (int i = 0; i < m_iCount; i++)
+					{
+						m_pObjects[i] = m_pObjects[i + l_iBatch];
+					}
+
+					m_iFlushes++;
+				}
+
+				m_pObjects[m_iCount++] = a_pAddress;
+			}
+
+
+			//Returns every object in the magazine to the pool
+			void flush()
+			{
+				if (m_iCount > 0)
+				{
+					m_pPool->pushChain(m_pObjects, m_iCount);
+					m_iCount = 0;
+					m_iFlushes++;
+				}
+			}
+
+
+			//Getter for the most objects the magazine will hold
+			int capacity() const
+			{
+				return m_iCapacity;
+			}
+
+			//Returns number of objects currently held in the magazine
+			int count() const
+			{
+				return m_iCount;
+			}
+
+			//Returns number of times the magazine has refilled from the pool
+			long long refillCount() const
+			{
+				return m_iRefills;
+			}
+
+			//Returns number of times the magazine has flushed to the pool
+			long long flushCount() const
+			{
+				return m_iFlushes;
+			}
+
+
+	};
+
+
+#endif
@@ -0,0 +1,192 @@
+/*
+	NovaCorps - PoolMemory.h
+
+	This header file describes the PoolHeapMemory and PoolHugePageMemory classes.
+
+		These are memory policies: they decide where a pool's block of objects comes from. A
+	SlabPool (see SlabPool.h) takes one as an optional template argument and allocates its slab
+	through it. Each policy has an .allocate(bytes, alignment) that returns memory for the block or
+	throws std::bad_alloc, and a .deallocate(memory, bytes, alignment) that gives it back and must be
+	passed the same size and alignment.
+
+		PoolHeapMemory is the default, and simply uses aligned operator new.
+
+		PoolHugePageMemory is for very big pools, where walking objects spread over millions of 4KB
+	pages means constant TLB misses. On Linux it maps the block directly with mmap, aligned to 2MB,
+	and asks the kernel to back it with transparent huge pages (MADV_HUGEPAGE). It can instead ask
+	for explicit 2MB pages (MAP_HUGETLB), falling back to transparent huge pages if none have been
+	reserved. It can also bind the block to one NUMA node with mbind, so the memory sits next to the
+	cores that use it. Every block is rounded up to a whole number of 2MB pages, so it's wasteful
+	for small pools. On other systems it falls back to operator new.
+
+	For example:
+
+		SlabPool<Particle, PoolHugePageMemory> pool(4000000, PoolHugePageMemory(0));
+
+*/
+
+
+#ifndef POOL_MEMORY_H
+
+	#define POOL_MEMORY_H
+
+	#include <cstddef>
+	#include <new>
+
+	#ifdef __linux__
+		#include <sys/mman.h>
+		#include <sys/syscall.h>
+		#include <unistd.h>
+	#endif
+
+	//Memory policy that allocates from the heap with aligned operator new
+	class PoolHeapMemory
+	{
+		//Public members
+		public:
+
+			//Returns memory for a_iBytes bytes aligned to a_iAlignment (a power of two). Throws std::bad_alloc if out of memory
+			void* allocate(const std::size_t a_iBytes, const std::size_t a_iAlignment)
+			{
+				return ::operator new(a_iBytes, std::align_val_t(a_iAlignment));
+			}
+
+			//Gives back memory from allocate, which must be passed the same size and alignment it was allocated with
+			void deallocate(void* a_pMemory, const std::size_t, const std::size_t a_iAlignment)
+			{
+				::operator delete(a_pMemory, std::align_val_t(a_iAlignment));
+			}
+
+
+	};
+
+
+	//Memory policy that backs blocks with 2MB huge pages, optionally bound to a NUMA node
+	class PoolHugePageMemory
+	{
+		//Private members
+		private:
+
+			//Size of a huge page, which every block is aligned to and rounded up to
+			static constexpr std::size_t s_iPageSize = 2 * 1024 * 1024;
+
+			//NUMA node to bind blocks to, or -1 to leave placement to the kernel
+			int m_iNode;
+
+			//Set to ask for explicit huge pages before falling back to transparent ones
+			bool m_bExplicitPages;
+
+
+			//Returns the size of the mapping behind a block of a_iBytes
+			static std::size_t mappedSize(const std::size_t a_iBytes)
+			{
+				return (a_iBytes + s_iPageSize - 1) / s_iPageSize * s_iPageSize;
+			}
+
+		#ifdef __linux__
+
+			//Maps a_iLength bytes on a huge page boundary, or returns nullptr if the system couldn't
+			void* map(const std::size_t a_iLength)
+			{
+				#ifdef MAP_HUGETLB
+				//Explicit huge pages come from the reserved pool and are always aligned to their size
+				if (m_bExplicitPages)
+				{
+					void* l_pMemory = mmap(nullptr, a_iLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+					if (l_pMemory != MAP_FAILED) return l_pMemory;
+				}
+				#endif
+
+				//Otherwise map an extra page's worth, then unmap whatever hangs over either side of the aligned block
+				void* l_pMapping = mmap(nullptr, a_iLength + s_iPageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+				if (l_pMapping == MAP_FAILED) return nullptr;
+
+				char* l_pStart = static_cast<char*>(l_pMapping);
+				char* l_pAligned = reinterpret_cast<char*>((reinterpret_cast<std::size_t>(l_pStart) + s_iPageSize - 1) / s_iPageSize * s_iPageSize);
+
+				if (l_pAligned > l_pStart) munmap(l_pStart, l_pAligned - l_pStart);
+				munmap(l_pAligned + a_iLength, l_pStart + s_iPageSize - l_pAligned);
+
+				#ifdef MADV_HUGEPAGE
+				madvise(l_pAligned, a_iLength, MADV_HUGEPAGE);
+				#endif
+
+				return l_pAligned;
+			}
+
+			//Binds the pages of a block to our NUMA node. Must happen before the block is first touched.
+			//Called straight through the system call so there's no need to link against libnuma
+			void bind(void* a_pMemory, const std::size_t a_iLength)
+			{
+				#ifdef SYS_mbind
+				//Room for 1024 nodes, which is as many as Linux supports
+				const int l_iWordBits = static_cast<int>(sizeof(unsigned long) * 8);
+				unsigned long l_pNodeMask[1024 / (sizeof(unsigned long) * 8)] = {};
+
+				if (m_iNode < 0 || m_iNode >= 1023) return;
+				l_pNodeMask[m_iNode / l_iWordBits] = 1UL << (m_iNode % l_iWordBits);
+
+				//MPOL_BIND is 2. If binding fails (no such node, say) the block is simply left wherever the kernel puts it
+				syscall(SYS_mbind, a_pMemory, a_iLength, 2, l_pNodeMask, sizeof(l_pNodeMask) * 8, 0);
+				#endif
+			}
+
+		#endif
+
+
+		//Public members
+		public:
+
+			//Creates a policy that binds blocks to NUMA node a_iNode (or doesn't bind them, if it's -1), and asks for explicit
+			//2MB pages first if a_bExplicitPages is set
+			explicit PoolHugePageMemory(const int a_iNode = -1, const bool a_bExplicitPages = false)
+				: m_iNode(a_iNode), m_bExplicitPages(a_bExplicitPages)
+			{
+			}
+
+
+			//Returns memory for a_iBytes bytes aligned to a_iAlignment, which can be anything up to 2MB.
+			//Throws std::bad_alloc if out of memory
+			void* allocate(const std::size_t a_iBytes, const std::size_t a_iAlignment)
+			{
+			#ifdef __linux__
+				//Blocks are aligned to 2MB, which covers any alignment that might be asked for
+				(void)a_iAlignment;
+
+				const std::size_t l_iLength = mappedSize(a_iBytes > 0 ? a_iBytes : 1);
+
+				void* l_pMemory = map(l_iLength);
+				if (l_pMemory == nullptr) throw std::bad_alloc();
+
+				bind(l_pMemory, l_iLength);
+
+				return l_pMemory;
+			#else
+				return ::operator new(a_iBytes, std::align_val_t(a_iAlignment > s_iPageSize ? a_iAlignment : s_iPageSize));
+			#endif
+			}
+
+			//Gives back memory from allocate, which must be passed the same size and alignment it was allocated with
+			void deallocate(void* a_pMemory, const std::size_t a_iBytes, const std::size_t a_iAlignment)
+			{
+			#ifdef __linux__
+				(void)a_iAlignment;
+
+				if (a_pMemory != nullptr) munmap(a_pMemory, mappedSize(a_iBytes > 0 ? a_iBytes : 1));
+			#else
+				::operator delete(a_pMemory, std::align_val_t(a_iAlignment > s_iPageSize ? a_iAlignment : s_iPageSize));
+			#endif
+			}
+
+
+			//Getter for the NUMA node blocks are bound to, or -1 if they aren't bound
+			int node() const
+			{
+				return m_iNode;
+			}
+
+
+	};
+
+
+#endif
@@ -0,0 +1,96 @@
+/*
+	NovaCorps - PoolMemoryResource.h
+
+	This header file describes the PoolMemoryResource class.
+
+		A PoolMemoryResource is a std::pmr::memory_resource that serves allocations from a
+	PoolAllocator (see PoolAllocator.h), so pmr containers can keep their nodes and buffers in pooled
+	memory. Requests too big for the allocator's pools are passed on to an upstream resource, which
+	is the program's default resource unless another is given.
+
+		Like the PoolAllocator underneath it, a PoolMemoryResource is not thread-safe.
+
+	For example:
+
+		PoolMemoryResource resource;
+
+		std::pmr::list<int> l_list(&resource);
+		std::pmr::unordered_map<int, Bullet> l_map(&resource);
+
+*/
+
+
+#ifndef POOL_MEMORY_RESOURCE_H
+
+	#define POOL_MEMORY_RESOURCE_H
+
+	#include <cstddef>
+	#include <memory_resource>
+
+	#include "PoolAllocator.h"
+
+	class PoolMemoryResource : public std::pmr::memory_resource
+	{
+		//Private members
+		private:
+
+			//Serves every request that fits in one of its pools
+			PoolAllocator m_allocator;
+
+			//Serves everything else
+			std::pmr::memory_resource* m_pUpstream;
+
+
+			//Returns memory from the allocator's pools, or from upstream if the request is too big for them
+			void* do_allocate(const std::size_t a_iBytes, const std::size_t a_iAlignment) override
+			{
+				if (m_allocator.bucketFor(a_iBytes, a_iAlignment) != nullptr) return m_allocator.allocate(a_iBytes, a_iAlignment);
+
+				return m_pUpstream->allocate(a_iBytes, a_iAlignment);
+			}
+
+			//Gives memory back to wherever do_allocate got it from
+			void do_deallocate(void* a_pMemory, const std::size_t a_iBytes, const std::size_t a_iAlignment) override
+			{
+				if (m_allocator.bucketFor(a_iBytes, a_iAlignment) != nullptr) m_allocator.deallocate(a_pMemory, a_iBytes, a_iAlignment);
+				else m_pUpstream->deallocate(a_pMemory, a_iBytes, a_iAlignment);
+			}
+
+			//Memory from one resource can only go back to the same resource
+			bool do_is_equal(const std::pmr::memory_resource& a_other) const noexcept override
+			{
+				return this == &a_other;
+			}
+
+
+		//Public members
+		public:
+
+			//Creates a resource whose pools each grow a chunk of about a_iChunkBytes at a time, passing big requests to a_pUpstream
+			explicit PoolMemoryResource(std::pmr::memory_resource* a_pUpstream = std::pmr::get_default_resource(), const std::size_t a_iChunkBytes = 64 * 1024)
+				: m_allocator(a_iChunkBytes), m_pUpstream(a_pUpstream)
+			{
+			}
+
+			//The resource owns its pools outright, so it can't be copied
+			PoolMemoryResource(const PoolMemoryResource&) = delete;
+			PoolMemoryResource& operator=(const PoolMemoryResource&) = delete;
+
+
+			//Getter for the PoolAllocator behind this resource
+			const PoolAllocator& allocator() const
+			{
+				return m_allocator;
+			}
+
+			//Getter for the resource big requests are passed on to
+			std::pmr::memory_resource* upstream() const
+			{
+				return m_pUpstream;
+			}
+
+
+	};
+
+
+#endif
@@ -0,0 +1,295 @@
+/*
+	NovaCorps - PoolScheduler.h
+
+	This header file describes the PoolScheduler class.
+
+		A PoolScheduler is a small work-stealing thread pool used to run a loop over a range of
+	indices across several cores, such as Pool's .parallelForEachActive().
+
+		The range is cut into chunks of a given grain size and dealt out evenly between the worker
+	threads and the calling thread, each of which keeps its chunks in its own queue. Each thread
+	works through its own queue from the back, and once that's empty it steals from the front of
+	another thread's queue, so uneven chunks still finish at roughly the same time. The calling
+	thread joins in, and .parallelFor() doesn't return until every chunk is done.
+
+		If the loop's function throws, on any thread, the chunks not yet started are skipped, and once
+	the chunks already running have finished the first exception is rethrown from .parallelFor() on
+	the calling thread.
+
+		Only one loop runs on a scheduler at a time. A loop's function must not start another loop
+	on the same scheduler, as that would wait forever for the first loop to finish.
+
+*/
+
+
+#ifndef POOL_SCHEDULER_H
+
+	#define POOL_SCHEDULER_H
+
+	#include <atomic>
+	#include <condition_variable>
+	#include <deque>
+	#include <exception>
+	#include <functional>
+	#include <memory>
+	#include <mutex>
+	#include <thread>
+	#include <vector>
+
+	class PoolScheduler
+	{
+		//Private members
+		private:
+
+			//A chunk of the range, from begin up to but not including end
+			struct Chunk
+			{
+				int begin;
+				int end;
+			};
+
+			//Each thread's queue of chunks, with its own lock so threads only contend when stealing
+			struct Queue
+			{
+				std::mutex mutex;
+				std::deque<Chunk> chunks;
+			};
+
+			//The worker threads
+			std::vector<std::thread> m_vThreads;
+
+			//One queue per worker thread, plus one for the calling thread at the end
+			std::unique_ptr<Queue[]> m_pQueues;
+
+			//Function run on each chunk of the current loop
+			std::function<void(int, int)> m_fnChunk;
+
+			//Number of chunks of the current loop not yet finished
+			std::atomic<int> m_iRemaining{0};
+
+			//Set once a chunk of the current loop has thrown, after which the rest are skipped rather than run
+			std::atomic<bool> m_bFailed{false};
+
+			//The first exception thrown by a chunk of the current loop, guarded by m_mutex
+			std::exception_ptr m_pException;
+
+			//Bumped each time a loop starts, which is what wakes the workers
+			unsigned m_iGeneration = 0;
+
+			//Set when the scheduler is being destroyed
+			bool m_bStopping = false;
+
+			//Guards the generation and stopping flag, and is used with the two conditions below
+			std::mutex m_mutex;
+			std::condition_variable m_cvStart;
+			std::condition_variable m_cvFinished;
+
+			//Stops two loops being started on the scheduler at once
+			std::mutex m_callMutex;
+
+
+			//Takes a chunk from the back of our own queue, or failing that from the front of someone else's
+			bool takeChunk(const int a_iQueue, Chunk& a_chunk)
+			{
+				const int l_iQueues = static_cast<int>(m_vThreads.size()) + 1;
+
+				for (int i = 0; i < l_iQueues; i++)
+				{
+					Queue& l_queue = m_pQueues[(a_iQueue + i) % l_iQueues];
+					std::lock_guard<std::mutex> l_lock(l_queue.mutex);
+
+					if (!l_queue.chunks.empty())
+					{
+						if (i == 0)
+						{
+							a_chunk = l_queue.chunks.back();
+							l_queue.chunks.pop_back();
+						}
+						else
+						{
+							a_chunk = l_queue.chunks.front();
+							l_queue.chunks.pop_front();
+						}
+						return true;
+					}
+				}
+
+				return false;
+			}
+
+			//Runs chunks until there are none left to take anywhere
+			void runChunks(const int a_iQueue)
+			{
+				Chunk l_chunk;
+
+				while (takeChunk(a_iQueue, l_chunk))
+				{
+					//Catch anything the chunk throws, so it can be passed on to the calling thread rather than end the program
+					if (!m_bFailed.load(std::memory_order_relaxed))
+					{
+						try
+						{
+							m_fnChunk(l_chunk.begin, l_chunk.end);
+						}
+						catch (...)
+						{
+							std::lock_guard<std::mutex> l_lock(m_mutex);
+							if (!m_pException) m_pException = std::current_exception();
+							m_bFailed.store(true, std::memory_order_relaxed);
+						}
+					}
+
+					//The last chunk to finish wakes up the calling thread
+					if (m_iRemaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+					{
+						std::lock_guard<std::mutex> l_lock(m_mutex);
+						m_cvFinished.notify_all();
+					}
+				}
+			}
+
+			//What each worker thread runs: wait for a loop to start, help finish it, repeat
+			void workerLoop(const int a_iQueue)
+			{
+				unsigned l_iSeenGeneration = 0;
+
+				for (;;)
+				{
+					{
+						std::unique_lock<std::mutex> l_lock(m_mutex);
+						m_cvStart.wait(l_lock, [&] { return m_bStopping || m_iGeneration != l_iSeenGeneration; });
+
+						if (m_bStopping) return;
+						l_iSeenGeneration = m_iGeneration;
+					}
+
+					runChunks(a_iQueue);
+				}
+			}
+
+
+		//Public members
+		public:
+
+			//Creates a scheduler with the given number of worker threads. The calling thread also works, so by default
+			//this is one fewer than the number of hardware threads
+			explicit PoolScheduler(int a_iThreads = -1)
+			{
+				if (a_iThreads < 0)
+				{
+					a_iThreads = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+					if (a_iThreads < 0) a_iThreads = 0;
+				}
+
+				m_pQueues.reset(new Queue[a_iThreads + 1]);
+
+				m_vThreads.reserve(a_iThreads);
+				for (int i = 0; i < a_iThreads; i++)
+				{
+					m_vThreads.emplace_back(&PoolScheduler::workerLoop, this, i);
+				}
+			}
+
+			//A scheduler owns its threads, so it can't be copied
+			PoolScheduler(const PoolScheduler&) = delete;
+			PoolScheduler& operator=(const PoolScheduler&) = delete;
+
+			//Destructor. Stops and joins the worker threads
+			~PoolScheduler()
+			{
+				{
+					std::lock_guard<std::mutex> l_lock(m_mutex);
+					m_bStopping = true;
+				}
+				m_cvStart.notify_all();
+
+				for (std::thread& l_thread : m_vThreads)
+				{
+					l_thread.join();
+				}
+			}
+
+
+			//Returns a scheduler shared by the whole program, created the first time it's asked for
+			static PoolScheduler& shared()
+			{
+				static PoolScheduler s_scheduler;
+				return s_scheduler;
+			}
+
+
+			//Calls a_function(begin, end) on chunks of at most a_iGrain indices covering [a_iBegin, a_iEnd), spread across the
+			//worker threads and the calling thread. Returns once every chunk has been run. If a_function throws, the first
+			//exception is rethrown here once no chunk is running any more
+			template <class function>
+			void parallelFor(const int a_iBegin, const int a_iEnd, int a_iGrain, function a_function)
+			{
+				if (a_iEnd <= a_iBegin) return;
+				if (a_iGrain < 1) a_iGrain = 1;
+
+				std::lock_guard<std::mutex> l_callLock(m_callMutex);
+
+				const int l_iQueues = static_cast<int>(m_vThreads.size()) + 1;
+				const int l_iChunks = (a_iEnd - a_iBegin + a_iGrain - 1) / a_iGrain;
+
+				//Nothing to share out, so don't bother waking anyone
+				if (l_iChunks == 1 || l_iQueues == 1)
+				{
+					for (int l_iStart = a_iBegin; l_iStart < a_iEnd; l_iStart += a_iGrain)
+					{
+						a_function(l_iStart, a_iEnd - l_iStart < a_iGrain ? a_iEnd : l_iStart + a_iGrain);
+					}
+					return;
+				}
+
+				m_fnChunk = [&a_function](int a_iChunkBegin, int a_iChunkEnd) { a_function(a_iChunkBegin, a_iChunkEnd); };
+				m_iRemaining.store(l_iChunks, std::memory_order_relaxed);
+				m_bFailed.store(false, std::memory_order_relaxed);
+
+				//Deal each queue a neighbouring run of chunks, so each thread starts out working on memory next to itself
+				for (int i = 0; i < l_iChunks; i++)
+				{
+					const int l_iStart = a_iBegin + i * a_iGrain;
+					const Chunk l_chunk = { l_iStart, a_iEnd - l_iStart < a_iGrain ? a_iEnd : l_iStart + a_iGrain };
+
+					Queue& l_queue = m_pQueues[static_cast<long long>(i) * l_iQueues / l_iChunks];
+					std::lock_guard<std::mutex> l_lock(l_queue.mutex);
+					l_queue.chunks.push_front(l_chunk);
+				}
+
+				{
+					std::lock_guard<std::mutex> l_lock(m_mutex);
+					m_iGeneration++;
+				}
+				m_cvStart.notify_all();
+
+				//Help out, then wait for any chunks still running on other threads. Chunks that throw still count as
+				//finished, so this always returns, and a_function is never used again once it has
+				runChunks(l_iQueues - 1);
+
+				std::unique_lock<std::mutex> l_lock(m_mutex);
+				m_cvFinished.wait(l_lock, [&] { return m_iRemaining.load(std::memory_order_acquire) == 0; });
+
+				//Drop our reference to a_function, which is about to go out of scope
+				m_fnChunk = nullptr;
+
+				if (m_pException)
+				{
+					std::exception_ptr l_pException = m_pException;
+					m_pException = nullptr;
+					std::rethrow_exception(l_pException);
+				}
+			}
+
+
+			//Returns number of worker threads, not counting the calling thread
+			int threadCount() const
+			{
+				return static_cast<int>(m_vThreads.size());
+			}
+
+
+	};
+
+
+#endif
@@ -0,0 +1,120 @@
+/*
+	NovaCorps - PoolStdAllocator.h
+
+	This header file describes the PoolStdAllocator class.
+
+		A PoolStdAllocator is a standard allocator that draws its memory from a PoolAllocator (see
+	PoolAllocator.h), for containers that take an allocator as a template argument rather than a
+	std::pmr resource. Node-based containers such as std::list, std::map and std::set allocate one
+	small node at a time, which is exactly what the PoolAllocator's size classes are for.
+
+		The allocator only holds a pointer to its PoolAllocator, so it is cheap to copy, and copies
+	(including copies rebound to other types, as containers do for their nodes) share the same
+	pools. Two PoolStdAllocators compare equal when they use the same PoolAllocator, which must
+	outlive every container using it. Like the PoolAllocator, it is not thread-safe.
+
+	For example:
+
+		PoolAllocator allocator;
+
+		std::list<Bullet, PoolStdAllocator<Bullet>> l_bullets{ PoolStdAllocator<Bullet>(allocator) };
+		std::map<int, Bullet, std::less<int>, PoolStdAllocator<std::pair<const int, Bullet>>> l_map{ PoolStdAllocator<std::pair<const int, Bullet>>(allocator) };
+
+*/
+
+
+#ifndef POOL_STD_ALLOCATOR_H
+
+	#define POOL_STD_ALLOCATOR_H
+
+	#include <cstddef>
+	#include <limits>
+	#include <new>
+	#include <type_traits>
+
+	#include "PoolAllocator.h"
+
+	template <class type>
+	class PoolStdAllocator
+	{
+		//Rebound copies need to see each other's PoolAllocator
+		template <class other>
+		friend class PoolStdAllocator;
+
+		//Private members
+		private:
+
+			//Where the memory comes from
+			PoolAllocator* m_pAllocator;
+
+
+		//Public members
+		public:
+
+			typedef type value_type;
+
+			//The allocator has state, so containers must compare allocators, and should carry theirs along when moved or swapped
+			typedef std::false_type is_always_equal;
+			typedef std::true_type propagate_on_container_move_assignment;
+			typedef std::true_type propagate_on_container_swap;
+
+			template <class rebound>
+			struct rebind
+			{
+				typedef PoolStdAllocator<rebound> other;
+			};
+
+
+			//Creates an allocator that draws from the given PoolAllocator
+			PoolStdAllocator(PoolAllocator& a_allocator) noexcept
+				: m_pAllocator(&a_allocator)
+			{
+			}
+
+			//Creates an allocator for this type that shares a_other's PoolAllocator
+			template <class other>
+			PoolStdAllocator(const PoolStdAllocator<other>& a_other) noexcept
+				: m_pAllocator(a_other.m_pAllocator)
+			{
+			}
+
+
+			//Returns uninitialised memory for a_iCount objects
+			type* allocate(const std::size_t a_iCount)
+			{
+				if (a_iCount > std::numeric_limits<std::size_t>::max() / sizeof(type)) throw std::bad_array_new_length();
+
+				return static_cast<type*>(m_pAllocator->allocate(a_iCount * sizeof(type), alignof(type)));
+			}
+
+			//Gives back memory for a_iCount objects from allocate
+			void deallocate(type* a_pMemory, const std::size_t a_iCount) noexcept
+			{
+				m_pAllocator->deallocate(a_pMemory, a_iCount * sizeof(type), alignof(type));
+			}
+
+
+			//Getter for the PoolAllocator this draws from
+			PoolAllocator& allocator() const noexcept
+			{
+				return *m_pAllocator;
+			}
+
+
+			template <class other>
+			bool operator==(const PoolStdAllocator<other>& a_other) const noexcept
+			{
+				return m_pAllocator == a_other.m_pAllocator;
+			}
+
+			template <class other>
+			bool operator!=(const PoolStdAllocator<other>& a_other) const noexcept
+			{
+				return m_pAllocator != a_other.m_pAllocator;
+			}
+
+
+	};
+
+
+#endif
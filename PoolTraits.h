@@ -0,0 +1,83 @@
+/*
+	NovaCorps - PoolTraits.h
+
+	This header file describes the hooks the pools use to prepare objects for reuse.
+
+		PoolReset<type>::reset(object) is called on every object as it is released back to a pool.
+	By default it does nothing, so released objects keep whatever properties they had. To clear
+	out an object on release (drop references it holds, zero a counter, etc.), specialise it for
+	your type:
+
+		template <>
+		struct PoolReset<Bullet>
+		{
+			static void reset(Bullet& a_bullet)
+			{
+				a_bullet.target = nullptr;
+			}
+		};
+
+		PoolInPlace is a tag for pool constructors that build every object from the same constructor
+	arguments, rather than default constructing or copying them.
+
+		PoolReinitialise<type>::apply(object, args...) is what .emplaceNext(args...) uses to give a
+	retrieved object a fresh value. If the type can be constructed from the arguments without
+	throwing, the old object is destroyed and the new one constructed in its place with no
+	temporary. Otherwise a temporary is constructed first and moved in, so a throwing constructor
+	leaves the old object intact.
+
+*/
+
+
+#ifndef POOL_TRAITS_H
+
+	#define POOL_TRAITS_H
+
+	#include <new>
+	#include <type_traits>
+	#include <utility>
+
+	template <class type>
+	struct PoolReset
+	{
+		//Called on an object as it is released back to its pool
+		static void reset(type&)
+		{
+		}
+	};
+
+
+	//Tag used to pass constructor arguments straight through to a pool's objects, see Pool(size, PoolInPlace(), args...)
+	struct PoolInPlace
+	{
+	};
+
+
+	template <class type>
+	struct PoolReinitialise
+	{
+		//Gives the object at the given address a fresh value constructed from the given arguments
+		template <class... args>
+		static void apply(type* a_pObject, args&&... a_args)
+		{
+			rebuild(std::integral_constant<bool, std::is_nothrow_constructible<type, args&&...>::value>(), a_pObject, std::forward<args>(a_args)...);
+		}
+
+		//Construction can't throw, so rebuild the object where it stands
+		template <class... args>
+		static void rebuild(std::true_type, type* a_pObject, args&&... a_args)
+		{
+			a_pObject->~type();
+			new (a_pObject) type(std::forward<args>(a_args)...);
+		}
+
+		//Construction might throw, so build the new value on the side and only then move it in
+		template <class... args>
+		static void rebuild(std::false_type, type* a_pObject, args&&... a_args)
+		{
+			*a_pObject = type(std::forward<args>(a_args)...);
+		}
+	};
+
+
+#endif
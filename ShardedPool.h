@@ -0,0 +1,336 @@
+/*
+	NovaCorps - ShardedPool.h
+
+	This header file describes the ShardedPool class.
+
+		A ShardedPool is a thread-safe pool for machines with more than one NUMA node (typically one
+	per CPU socket), where memory attached to another socket is noticeably slower to reach. It keeps
+	one SlabPool (see SlabPool.h) per node, called a shard, whose slab is bound to that node's memory
+	with a PoolHugePageMemory (see PoolMemory.h).
+
+		.getNext() serves each thread from the shard on the node it's running on, so objects start
+	out in memory local to the thread using them. Only when that shard has nothing free does it
+	steal from the other shards in turn. .release(object) hands the object back to whichever shard
+	it came from, wherever it's released. The pool counts how many retrieves were served locally,
+	how many had to go to another node, and how many found nothing free anywhere, which shows
+	whether the shards are sized right for the load on each node.
+
+		Each shard has its own lock, so threads on different nodes don't contend with each other.
+	On a machine with a single node, or on systems other than Linux, a ShardedPool is simply a
+	locked SlabPool with one shard.
+
+	For example:
+
+		ShardedPool<Request> pool(100000);
+
+		Request* l_pRequest = pool.getNext();
+		...
+		pool.release(l_pRequest);
+
+		double l_fLocalRate = double(pool.localHitCount()) / (pool.localHitCount() + pool.remoteHitCount());
+
+*/
+
+
+#ifndef SHARDED_POOL_H
+
+	#define SHARDED_POOL_H
+
+	#include <atomic>
+	#include <cstdlib>
+	#include <fstream>
+	#include <memory>
+	#include <mutex>
+	#include <string>
+	#include <utility>
+	#include <vector>
+
+	#ifdef __linux__
+		#include <sched.h>
+	#endif
+
+	#include "PoolHandle.h"
+	#include "PoolMemory.h"
+	#include "SlabPool.h"
+
+	template <class type>
+	class ShardedPool
+	{
+		//Private members
+		private:
+
+			//One node's pool, its lock, and how often it's been used. Each shard sits on its own cache lines so threads on
+			//different nodes don't fight over them
+			struct alignas(64) Shard
+			{
+				std::mutex mutex;
+				SlabPool<type, PoolHugePageMemory> pool;
+
+				//The node the shard's memory is on, numbered as by currentNode()
+				const int node;
+
+				//Retrieves served by this shard for threads on its own node, and for threads on other nodes
+				std::atomic<long long> localHits{0};
+				std::atomic<long long> remoteHits{0};
+
+				//Creates a shard on the a_iNode'th node, whose id in sysfs is a_iNodeId
+				Shard(const int a_iSize, const int a_iNode, const int a_iNodeId)
+					: pool(a_iSize, PoolHugePageMemory(a_iNodeId)), node(a_iNode)
+				{
+				}
+			};
+
+			//The shards, taking turns over the nodes in node order
+			std::vector<std::unique_ptr<Shard>> m_vShards;
+
+			//Number of retrieves that found nothing free in any shard
+			std::atomic<long long> m_iMisses{0};
+
+			//The NUMA nodes that have memory, in order, and for each CPU the position in that list of the node it belongs to
+			struct Topology
+			{
+				std::vector<int> nodes;
+				std::vector<int> cpuNodes;
+			};
+
+
+			//Reads a sysfs list such as "0-3,8-11" into every number it covers, or returns nothing if it can't be read
+			static std::vector<int> readList(const std::string& a_sPath)
+			{
+				std::vector<int> l_vNumbers;
+				std::ifstream l_file(a_sPath);
+				std::string l_sRange;
+
+				while (std::getline(l_file, l_sRange, ','))
+				{
+					const std::size_t l_iDash = l_sRange.find('-');
+					const int l_iFirst = std::atoi(l_sRange.c_str());
+					const int l_iLast = l_iDash == std::string::npos ? l_iFirst : std::atoi(l_sRange.c_str() + l_iDash + 1);
+
+					for (int i = l_iFirst; i <= l_iLast; i++) l_vNumbers.push_back(i);
+				}
+
+				return l_vNumbers;
+			}
+
+			//Reads the machine's nodes and which CPUs belong to each of them, once. CPUs on a node without memory of its own
+			//aren't in the table, and count as being on the first node
+			static const Topology& topology()
+			{
+				static const Topology s_topology = []()
+				{
+					Topology l_topology;
+
+				#ifdef __linux__
+					l_topology.nodes = readList("/sys/devices/system/node/has_memory");
+					if (l_topology.nodes.empty()) l_topology.nodes = readList("/sys/devices/system/node/online");
+
+					for (int i = 0; i < static_cast<int>(l_topology.nodes.size()); i++)
+					{
+						const std::string l_sNode = std::to_string(l_topology.nodes[i]);
+
+						for (int l_iCpu : readList("/sys/devices/system/node/node" + l_sNode + "/cpulist"))
+						{
+							if (l_iCpu >= static_cast<int>(l_topology.cpuNodes.size())) l_topology.cpuNodes.resize(l_iCpu + 1, 0);
+							l_topology.cpuNodes[l_iCpu] = i;
+						}
+					}
+				#endif
+
+					if (l_topology.nodes.empty()) l_topology.nodes.push_back(0);
+
+					return l_topology;
+				}();
+
+				return s_topology;
+			}
+
+
+			//Retrieves an object with a_take(pool), trying the shards on the calling thread's own node first and then the
+			//others. Returns nullptr if every shard is exhausted
+			template <class take>
+			type* takeNext(take a_take)
+			{
+				const int l_iShards = static_cast<int>(m_vShards.size());
+				const int l_iNode = currentNode();
+
+				//Threads on different nodes start from different shards, so they don't all queue on the first one
+				const int l_iStart = l_iNode % l_iShards;
+
+				//The first pass only visits shards on our node, the second only those elsewhere
+				for (int l_iPass = 0; l_iPass < 2; l_iPass++)
+				{
+					for (int i = 0; i < l_iShards; i++)
+					{
+						Shard& l_shard = *m_vShards[(l_iStart + i) % l_iShards];
+						const bool l_bLocal = l_shard.node == l_iNode;
+
+						if (l_bLocal != (l_iPass == 0)) continue;
+
+						type* l_pObject;
+
+						{
+							std::lock_guard<std::mutex> l_lock(l_shard.mutex);
+							l_pObject = a_take(l_shard.pool);
+						}
+
+						if (l_pObject != nullptr)
+						{
+							(l_bLocal ? l_shard.localHits : l_shard.remoteHits).fetch_add(1, std::memory_order_relaxed);
+							return l_pObject;
+						}
+					}
+				}
+
+				//throw std::overflow_error(__FILE__ ": <ShardedPool Error>: No available objects left in any shard. Try releasing some objects");
+				m_iMisses.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+
+		//Public members
+		public:
+
+			//Creates a ShardedPool with a_iSizePerShard default objects in each shard. There is one shard per NUMA node,
+			//unless a_iShards says otherwise, in which case the shards take turns over the nodes
+			explicit ShardedPool(const int a_iSizePerShard, int a_iShards = -1)
+			{
+				if (a_iShards < 1) a_iShards = nodeCount();
+
+				const std::vector<int>& l_vNodes = topology().nodes;
+
+				m_vShards.reserve(a_iShards);
+				for (int i = 0; i < a_iShards; i++)
+				{
+					const int l_iNode = i % static_cast<int>(l_vNodes.size());
+					m_vShards.emplace_back(new Shard(a_iSizePerShard, l_iNode, l_vNodes[l_iNode]));
+				}
+			}
+
+			//Each shard owns its objects outright, so a ShardedPool can't be copied
+			ShardedPool(const ShardedPool&) = delete;
+			ShardedPool& operator=(const ShardedPool&) = delete;
+
+
+			//Retrieves the next object, from the calling thread's own node if it has one free, or else from another node.
+			//Returns nullptr if there is nothing free anywhere
+			type* getNext()
+			{
+				return takeNext([](SlabPool<type, PoolHugePageMemory>& a_pool) { return a_pool.getNext(); });
+			}
+
+
+			//Retrieves the next object wrapped in a handle that releases it when the handle is destroyed.
+			//The handle is empty if there was nothing free.
+			PoolHandle<type, ShardedPool<type>> acquire()
+			{
+				return PoolHandle<type, ShardedPool<type>>(getNext(), this);
+			}
+
+
+			//Retrieves the next object as with getNext(), and gives it a fresh value constructed from the given arguments
+			//(see PoolTraits.h). Returns nullptr if there was nothing free.
+			template <class... args>
+			type* emplaceNext(args&&... a_args)
+			{
+				return takeNext([&](SlabPool<type, PoolHugePageMemory>& a_pool) { return a_pool.emplaceNext(std::forward<args>(a_args)...); });
+			}
+
+
+			//Releases the object at the given address back to the shard it came from, from any thread
+			void release(type* a_pAddress)
+			{
+				for (const std::unique_ptr<Shard>& l_pShard : m_vShards)
+				{
+					if (l_pShard->pool.owns(a_pAddress))
+					{
+						std::lock_guard<std::mutex> l_lock(l_pShard->mutex);
+						l_pShard->pool.release(a_pAddress);
+						return;
+					}
+				}
+
+				//throw std::range_error(__FILE__ ": <ShardedPool Error>: Given Address was not found in any shard");
+			}
+
+
+			//Returns number of shards
+			int shardCount() const
+			{
+				return static_cast<int>(m_vShards.size());
+			}
+
+			//Getter for the total size of all shards
+			int size() const
+			{
+				int l_iSize = 0;
+				for (const std::unique_ptr<Shard>& l_pShard : m_vShards) l_iSize += l_pShard->pool.size();
+
+				return l_iSize;
+			}
+
+			//Returns number of active objects across all shards. Other threads may change this as soon as it's returned
+			int activeCount()
+			{
+				int l_iActive = 0;
+
+				for (const std::unique_ptr<Shard>& l_pShard : m_vShards)
+				{
+					std::lock_guard<std::mutex> l_lock(l_pShard->mutex);
+					l_iActive += l_pShard->pool.activeCount();
+				}
+
+				return l_iActive;
+			}
+
+
+			//Returns number of retrieves served by a shard on the retrieving thread's own node
+			long long localHitCount() const
+			{
+				long long l_iHits = 0;
+				for (const std::unique_ptr<Shard>& l_pShard : m_vShards) l_iHits += l_pShard->localHits.load(std::memory_order_relaxed);
+
+				return l_iHits;
+			}
+
+			//Returns number of retrieves that had to be served by another node because the shards on the local node were exhausted
+			long long remoteHitCount() const
+			{
+				long long l_iHits = 0;
+				for (const std::unique_ptr<Shard>& l_pShard : m_vShards) l_iHits += l_pShard->remoteHits.load(std::memory_order_relaxed);
+
+				return l_iHits;
+			}
+
+			//Returns number of retrieves that found nothing free in any shard
+			long long missCount() const
+			{
+				return m_iMisses.load(std::memory_order_relaxed);
+			}
+
+
+			//Returns number of NUMA nodes with memory on this machine, or 1 if it can't tell
+			static int nodeCount()
+			{
+				return static_cast<int>(topology().nodes.size());
+			}
+
+			//Returns which of the nodeCount() nodes the calling thread is running on right now, counting from 0 in node
+			//order, or 0 if it can't tell. This is a lookup of the thread's CPU, so it's cheap enough to call on every retrieve
+			static int currentNode()
+			{
+			#ifdef __linux__
+				const int l_iCpu = sched_getcpu();
+				const std::vector<int>& l_vCpuNodes = topology().cpuNodes;
+
+				if (l_iCpu >= 0 && l_iCpu < static_cast<int>(l_vCpuNodes.size())) return l_vCpuNodes[l_iCpu];
+			#endif
+
+				return 0;
+			}
+
+
+	};
+
+
+#endif
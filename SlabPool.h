@@ -0,0 +1,458 @@
+/*
+	NovaCorps - SlabPool.h
+
+	This header file describes the SlabPool class.
+
+		A SlabPool behaves exactly like a Pool (see Pool.h): objects are retrieved with .getNext()
+	and handed back with .release(object), and the pool keeps its active and free objects in
+	separate halves of a single array of pointers.
+
+		The difference is where the objects live. A Pool creates every object separately on the
+	heap, so they end up scattered wherever the allocator puts them. A SlabPool constructs all of
+	its objects side by side in one cache-line aligned block of memory (the 'slab'), so creating the
+	pool is a single allocation and walking the active objects touches memory in order.
+
+		Objects never move once the slab is built, so an address returned by .getNext() stays valid
+	for the life of the pool. For the same reason a SlabPool has a fixed size and cannot be resized.
+
+		The slab's memory comes from a memory policy, given as the second template argument. By
+	default it's the heap, but a PoolHugePageMemory (see PoolMemory.h) backs it with huge pages,
+	optionally bound to a NUMA node, which is worth doing for pools of many megabytes or more.
+
+		A SlabPool can also be created with deferred construction, by passing a SlabLifetime as well
+	as the size. The slab is then reserved but left empty, and each object is only constructed the
+	first time it's retrieved: by .getNext() with its default constructor, or by .emplaceNext(args...)
+	with whichever constructor the arguments pick. This makes creating a big pool that's mostly
+	unused cheap, and means types without a default constructor can be pooled as long as they're
+	always retrieved with .emplaceNext(). SlabLifetime::KeepAlive keeps objects alive after release
+	so they can be reused as they are, and SlabLifetime::DestroyOnRelease destroys them on release.
+
+	Iterating a slab pool's actives works the same way as with a Pool:
+
+		int activeObjects;
+		auto objectsArray = pool.activeAddresses(&activeObjects);
+
+		for (int i = 0; i < activeObjects; i++)
+		{
+			//code to be run on objectsArray[i]
+		}
+
+*/
+
+
+#ifndef SLAB_POOL_H
+
+	#define SLAB_POOL_H
+
+	#include <cstddef>
+	#include <cstdint>
+	#include <new>
+	#include <vector>
+
+	#include "PoolHandle.h"
+	#include "PoolMemory.h"
+	#include "PoolTraits.h"
+
+	//What a SlabPool with deferred construction does with an object when it's released
+	enum class SlabLifetime
+	{
+		KeepAlive,
+		DestroyOnRelease
+	};
+
+	template <class type, class memory = PoolHeapMemory>
+	class SlabPool
+	{
+		//Private members
+		private:
+
+			//Objects are aligned to at least a cache line so the slab starts on a line boundary
+			static constexpr std::size_t s_iAlignment = alignof(type) > 64 ? alignof(type) : 64;
+
+			//The Size of the pool [default 10]
+			int m_iSize = 10;
+
+			//Pointer to the current position of the first free object in the pool
+			int m_iNextFreePosition = 0;
+
+			//The single block of memory every object in the pool is constructed in
+			type* m_pSlab = nullptr;
+
+			//Holds the pointer to the start of our array of pointers to objects in the slab
+			type** m_pArrayLocation = nullptr;
+
+			//Holds the current position in our array of the object at each index of the slab
+			int* m_pPositions = nullptr;
+
+			//Objects waiting to be released by flushReleases()
+			std::vector<type*> m_vPendingReleases;
+
+			//For pools with deferred construction, whether the object at each index of the slab currently exists.
+			//nullptr if every object was constructed up front
+			bool* m_pConstructed = nullptr;
+
+			//Set if objects are destroyed as they're released, rather than kept alive
+			bool m_bDestroyOnRelease = false;
+
+			//Where the slab's memory comes from (see PoolMemory.h)
+			memory m_memory;
+
+
+			//Allocates the slab and the arrays that track it, without constructing anything
+			void allocate(const int a_iSize)
+			{
+				m_iSize = a_iSize;
+				m_pSlab = static_cast<type*>(m_memory.allocate(sizeof(type) * a_iSize, s_iAlignment));
+				m_pArrayLocation = new type*[a_iSize];
+				m_pPositions = new int[a_iSize];
+			}
+
+			//Returns the index in the slab of the given address, or -1 if it doesn't point to an object in this slab
+			int slabIndex(const type* a_pAddress) const
+			{
+				const std::uintptr_t l_iStart = reinterpret_cast<std::uintptr_t>(m_pSlab);
+				const std::uintptr_t l_iAddress = reinterpret_cast<std::uintptr_t>(a_pAddress);
+
+				if (l_iAddress < l_iStart || l_iAddress >= l_iStart + sizeof(type) * m_iSize) return -1;
+				if ((l_iAddress - l_iStart) % sizeof(type) != 0) return -1;
+
+				return static_cast<int>((l_iAddress - l_iStart) / sizeof(type));
+			}
+
+			//Takes the next free slot, whether or not an object has been constructed in it yet, or returns nullptr if there are none
+			type* takeNext()
+			{
+				if (m_iNextFreePosition < m_iSize)
+				{
+					return m_pArrayLocation[m_iNextFreePosition++];
+				}
+				else
+				{
+					//throw std::overflow_error(__FILE__ ": <SlabPool Error>: No available objects left in pool. Try releasing some objects");
+					return nullptr;
+				}
+			}
+
+			//With deferred construction, default constructs the object in the given slot if there isn't one there yet
+			void ensureConstructed(type* a_pObject)
+			{
+				if (m_pConstructed != nullptr && !m_pConstructed[a_pObject - m_pSlab])
+				{
+					new (a_pObject) type();
+					m_pConstructed[a_pObject - m_pSlab] = true;
+				}
+			}
+
+
+		//Public members
+		public:
+
+			//Creates a SlabPool of a_size with default objects of given type, in memory from the given memory policy
+			SlabPool(const int a_iSize = 10, const memory& a_memory = memory())
+				: m_memory(a_memory)
+			{
+				if (a_iSize > 0)
+				{
+					allocate(a_iSize);
+
+					//Construct each object in its place in the slab and point to it
+					for (int i = 0; i < a_iSize; i++)
+					{
+						m_pArrayLocation[i] = new (m_pSlab + i) type();
+						m_pPositions[i] = i;
+					}
+				}
+				else
+				{
+					//throw std::range_error(__FILE__ ": <SlabPool Error>: Pool must have size greater than 0");
+					m_iSize = 0;
+				}
+			}
+
+			//Creates a SlabPool of a_size objects cloned from the given object, in memory from the given memory policy
+			SlabPool(const type* a_pObjectToPool, const int a_iSize, const memory& a_memory = memory())
+				: m_memory(a_memory)
+			{
+				if (a_iSize > 0)
+				{
+					allocate(a_iSize);
+
+					//Copy construct each clone in its place in the slab straight from the original object, and point to it
+					for (int i = 0; i < a_iSize; i++)
+					{
+						m_pArrayLocation[i] = new (m_pSlab + i) type(*a_pObjectToPool);
+						m_pPositions[i] = i;
+					}
+				}
+				else
+				{
+					//throw std::range_error(__FILE__ ": <SlabPool Error>: Pool must have size greater than 0");
+					m_iSize = 0;
+				}
+			}
+
+			//Creates a SlabPool of a_size objects with deferred construction: the slab is reserved now, but each object is only
+			//constructed when it's first retrieved, and a_lifetime decides whether it's destroyed again on release
+			SlabPool(const int a_iSize, const SlabLifetime a_lifetime, const memory& a_memory = memory())
+				: m_memory(a_memory)
+			{
+				if (a_iSize > 0)
+				{
+					allocate(a_iSize);
+
+					m_pConstructed = new bool[a_iSize]();
+					m_bDestroyOnRelease = a_lifetime == SlabLifetime::DestroyOnRelease;
+
+					//Point to each slot, even though nothing lives there yet
+					for (int i = 0; i < a_iSize; i++)
+					{
+						m_pArrayLocation[i] = m_pSlab + i;
+						m_pPositions[i] = i;
+					}
+				}
+				else
+				{
+					//throw std::range_error(__FILE__ ": <SlabPool Error>: Pool must have size greater than 0");
+					m_iSize = 0;
+				}
+			}
+
+			//The slab owns its objects outright, so a SlabPool can't be copied
+			SlabPool(const SlabPool&) = delete;
+			SlabPool& operator=(const SlabPool&) = delete;
+
+			//Destructor
+			virtual ~SlabPool()
+			{
+				//Objects were constructed in place, so they're destroyed in place before the slab is freed
+				for (int i = 0; i < m_iSize; i++)
+				{
+					if (m_pConstructed == nullptr || m_pConstructed[i]) m_pSlab[i].~type();
+				}
+
+				if (m_pSlab != nullptr) m_memory.deallocate(m_pSlab, sizeof(type) * m_iSize, s_iAlignment);
+				delete[] m_pArrayLocation;
+				delete[] m_pPositions;
+				delete[] m_pConstructed;
+			}
+
+
+			//Retrieves the next object in the pool, default constructing it first if construction was deferred
+			type* getNext()
+			{
+				type* l_pObject = takeNext();
+
+				if (l_pObject != nullptr)
+				{
+					//If the constructor throws, hand the slot back before passing the exception on
+					try
+					{
+						ensureConstructed(l_pObject);
+					}
+					catch (...)
+					{
+						m_iNextFreePosition--;
+						throw;
+					}
+				}
+
+				return l_pObject;
+			}
+
+
+			//Retrieves the next object in the pool wrapped in a handle that releases it when the handle is destroyed.
+			//The handle is empty if there was nothing free.
+			PoolHandle<type, SlabPool<type, memory>> acquire()
+			{
+				return PoolHandle<type, SlabPool<type, memory>>(getNext(), this);
+			}
+
+
+			//Retrieves the next object in the pool and gives it a fresh value constructed from the given arguments, in place where possible
+			//(see PoolTraits.h). If construction was deferred and the slot is empty, the object is simply constructed there.
+			//Returns nullptr if there was nothing free.
+			template <class... args>
+			type* emplaceNext(args&&... a_args)
+			{
+				type* l_pObject = takeNext();
+
+				if (l_pObject == nullptr) return nullptr;
+
+				if (m_pConstructed != nullptr && !m_pConstructed[l_pObject - m_pSlab])
+				{
+					//If the constructor throws, hand the slot back before passing the exception on
+					try
+					{
+						new (l_pObject) type(std::forward<args>(a_args)...);
+					}
+					catch (...)
+					{
+						m_iNextFreePosition--;
+						throw;
+					}
+
+					m_pConstructed[l_pObject - m_pSlab] = true;
+				}
+				else
+				{
+					PoolReinitialise<type>::apply(l_pObject, std::forward<args>(a_args)...);
+				}
+
+				return l_pObject;
+			}
+
+			//As emplaceNext, but wraps the object in a handle that releases it when the handle is destroyed.
+			template <class arg, class... args>
+			PoolHandle<type, SlabPool<type, memory>> acquire(arg&& a_arg, args&&... a_args)
+			{
+				return PoolHandle<type, SlabPool<type, memory>>(emplaceNext(std::forward<arg>(a_arg), std::forward<args>(a_args)...), this);
+			}
+
+
+			//Retrieves up to a_iCount objects in one go, writing them to a_pOut, and returns how many were retrieved
+			int getNext(const int a_iCount, type** a_pOut)
+			{
+				//Take as many as were asked for, or as many as are free if that's fewer
+				int l_iTaken = a_iCount < m_iSize - m_iNextFreePosition ? a_iCount : m_iSize - m_iNextFreePosition;
+				if (l_iTaken < 0) l_iTaken = 0;
+
+				//If a constructor throws, none of them have been taken yet, so they all stay free (those already constructed
+				//are marked as such)
+				for (int i = 0; i < l_iTaken; i++)
+				{
+					a_pOut[i] = m_pArrayLocation[m_iNextFreePosition + i];
+					ensureConstructed(a_pOut[i]);
+				}
+
+				//Move the pointer past all of them at once
+				m_iNextFreePosition += l_iTaken;
+
+				return l_iTaken;
+			}
+
+
+			//Releases the object at the given address from use and internally resorts the pool to keep active and free in separate halves
+			void release(type* a_pAddress)
+			{
+				//The object's place in the slab tells us where it currently sits in the array, so there's nothing to search
+				const int i_slabIndex = slabIndex(a_pAddress);
+				const int i_addressPositionInArray = i_slabIndex > -1 ? m_pPositions[i_slabIndex] : -1;
+
+				//Only active objects can be released
+				if (i_addressPositionInArray > -1 && i_addressPositionInArray < m_iNextFreePosition)
+				{
+					//Let the object clear itself out before it goes back in the pool, or destroy it if that's the policy
+					if (m_bDestroyOnRelease)
+					{
+						a_pAddress->~type();
+						m_pConstructed[i_slabIndex] = false;
+					}
+					else
+					{
+						PoolReset<type>::reset(*a_pAddress);
+					}
+
+					const int lastActive = m_iNextFreePosition - 1;
+
+					//Swap this object with the last active one, keeping the array split into active and free halves
+					type* lastActiveAddress = m_pArrayLocation[lastActive];
+					m_pArrayLocation[lastActive] = a_pAddress;
+					m_pArrayLocation[i_addressPositionInArray] = lastActiveAddress;
+
+					//Record where each of them has moved to
+					m_pPositions[i_slabIndex] = lastActive;
+					m_pPositions[lastActiveAddress - m_pSlab] = i_addressPositionInArray;
+
+					//The released object is now the first free one
+					m_iNextFreePosition--;
+				}
+				else
+				{
+					//throw std::range_error(__FILE__ ": <SlabPool Error>: Given Address was not found in active pool or was already inactive");
+				}
+			}
+
+
+			//Releases a_iCount objects in one pass, each swapped out of the active half as with release()
+			void releaseBulk(type** a_pAddresses, const int a_iCount)
+			{
+				for (int i = 0; i < a_iCount; i++)
+				{
+					release(a_pAddresses[i]);
+				}
+			}
+
+
+			//Marks the object at the given address to be released at the next flushReleases(), leaving the active half untouched
+			//until then. Safe to call while iterating over the actives
+			void releaseDeferred(type* a_pAddress)
+			{
+				m_vPendingReleases.push_back(a_pAddress);
+			}
+
+			//Releases every object marked with releaseDeferred, in one pass over them
+			void flushReleases()
+			{
+				if (m_vPendingReleases.empty()) return;
+
+				releaseBulk(m_vPendingReleases.data(), static_cast<int>(m_vPendingReleases.size()));
+				m_vPendingReleases.clear();
+			}
+
+			//Returns number of objects waiting to be released by flushReleases()
+			int pendingReleaseCount() const
+			{
+				return static_cast<int>(m_vPendingReleases.size());
+			}
+
+
+			//Getter for size of pool
+			int size() const
+			{
+				return m_iSize;
+			}
+
+			//Returns true if the given address is one of the objects in this pool
+			bool owns(const type* a_pAddress) const
+			{
+				return slabIndex(a_pAddress) > -1;
+			}
+
+			//Returns number of active elements in pool
+			int activeCount() const
+			{
+				return m_iNextFreePosition;
+			}
+
+			//Returns number of free elements in pool
+			int freeCount() const
+			{
+				return m_iSize - m_iNextFreePosition;
+			}
+
+
+			//Calls a_function on each active object in turn. The function must not retrieve or release objects from this pool
+			template <class function>
+			void forEachActive(function a_function)
+			{
+				const int l_iEnd = m_iNextFreePosition;
+
+				for (int i = 0; i < l_iEnd; i++)
+				{
+					a_function(*m_pArrayLocation[i]);
+				}
+			}
+
+
+			//Returns pointer to an array of addresses of all active elements in pool, with the number of them written to a_end
+			type** activeAddresses(int* a_end)
+			{
+				if (a_end != nullptr) *a_end = m_iNextFreePosition;
+				return m_pArrayLocation;
+			}
+
+
+	};
+
+
+#endif
@@ -0,0 +1,243 @@
+/*
+	NovaCorps - SoAPool.h
+
+	This header file describes the SoAPool class.
+
+		A SoAPool ("structure of arrays" pool) is for objects that are processed a field at a time.
+	Rather than pooling whole objects, the pool is given the type of each field as a column, and each
+	column is kept in its own contiguous, cache-line aligned array. An object is simply an index,
+	with its fields at that index in every column.
+
+		The columns are split into active and free halves exactly as a Pool's array is: indices below
+	activeCount() are active, and releasing an index swaps the last active object's fields into it.
+	So a loop over one field of every active object is a straight run over the start of one array,
+	which the compiler can vectorise, and no other fields are dragged through the cache.
+
+		Because release moves the last active object into the released index, indices are not stable:
+	after release(i), whatever was at activeCount() - 1 is now at i. Release while iterating by
+	walking the active range backwards.
+
+	For example, a pool of particles with a position, a velocity and a lifetime:
+
+		SoAPool<Vec3, Vec3, float> particles(10000);
+
+		const int l_iParticle = particles.getNext();
+		particles.column<0>()[l_iParticle] = spawnPoint;
+
+		Vec3* l_pPositions = particles.column<0>();
+		Vec3* l_pVelocities = particles.column<1>();
+
+		for (int i = 0; i < particles.activeCount(); i++)
+		{
+			l_pPositions[i] += l_pVelocities[i] * dt;
+		}
+
+*/
+
+
+#ifndef SOA_POOL_H
+
+	#define SOA_POOL_H
+
+	#include <cstddef>
+	#include <new>
+	#include <tuple>
+	#include <utility>
+
+	#if __cplusplus >= 202002L
+		#include <span>
+	#endif
+
+	template <class... columns>
+	class SoAPool
+	{
+		//Private members
+		private:
+
+			//Columns are aligned to at least a cache line, which also suits the widest vector loads
+			template <class column>
+			static constexpr std::size_t alignment()
+			{
+				return alignof(column) > 64 ? alignof(column) : 64;
+			}
+
+			//The Size of the pool [default 10]
+			int m_iSize = 10;
+
+			//Index of the first free object in the pool
+			int m_iNextFreePosition = 0;
+
+			//The arrays holding each column
+			std::tuple<columns*...> m_tColumns;
+
+
+			//Allocates and default constructs every column
+			template <std::size_t... indices>
+			void build(std::index_sequence<indices...>)
+			{
+				(buildColumn(std::get<indices>(m_tColumns)), ...);
+			}
+
+			template <class column>
+			void buildColumn(column*& a_pColumn)
+			{
+				a_pColumn = static_cast<column*>(::operator new(sizeof(column) * m_iSize, std::align_val_t(alignment<column>())));
+
+				for (int i = 0; i < m_iSize; i++)
+				{
+					new (a_pColumn + i) column();
+				}
+			}
+
+			//Destroys and frees every column
+			template <std::size_t... indices>
+			void destroy(std::index_sequence<indices...>)
+			{
+				(destroyColumn(std::get<indices>(m_tColumns)), ...);
+			}
+
+			template <class column>
+			void destroyColumn(column* a_pColumn)
+			{
+				if (a_pColumn == nullptr) return;
+
+				for (int i = 0; i < m_iSize; i++)
+				{
+					a_pColumn[i].~column();
+				}
+
+				::operator delete(a_pColumn, std::align_val_t(alignment<column>()));
+			}
+
+			//Swaps the fields of two objects in every column
+			template <std::size_t... indices>
+			void swapObjects(const int a_iFirst, const int a_iSecond, std::index_sequence<indices...>)
+			{
+				using std::swap;
+				(swap(std::get<indices>(m_tColumns)[a_iFirst], std::get<indices>(m_tColumns)[a_iSecond]), ...);
+			}
+
+
+		//Public members
+		public:
+
+			//Creates a SoAPool of a_size objects, with every field default constructed
+			SoAPool(const int a_iSize = 10)
+			{
+				if (a_iSize > 0)
+				{
+					m_iSize = a_iSize;
+					build(std::index_sequence_for<columns...>());
+				}
+				else
+				{
+					//throw std::range_error(__FILE__ ": <SoAPool Error>: Pool must have size greater than 0");
+					m_iSize = 0;
+				}
+			}
+
+			//The pool owns its columns outright, so it can't be copied
+			SoAPool(const SoAPool&) = delete;
+			SoAPool& operator=(const SoAPool&) = delete;
+
+			//Destructor
+			virtual ~SoAPool()
+			{
+				destroy(std::index_sequence_for<columns...>());
+			}
+
+
+			//Retrieves the next object in the pool, returning its index or -1 if there was nothing free
+			int getNext()
+			{
+				if (m_iNextFreePosition < m_iSize)
+				{
+					return m_iNextFreePosition++;
+				}
+				else
+				{
+					//throw std::overflow_error(__FILE__ ": <SoAPool Error>: No available objects left in pool. Try releasing some objects");
+					return -1;
+				}
+			}
+
+			//Retrieves up to a_iCount objects in one go. They are always next to each other, so this returns the index of the first
+			//and writes how many were retrieved to a_pRetrieved
+			int getNext(const int a_iCount, int* a_pRetrieved)
+			{
+				int l_iTaken = a_iCount < m_iSize - m_iNextFreePosition ? a_iCount : m_iSize - m_iNextFreePosition;
+				if (l_iTaken < 0) l_iTaken = 0;
+
+				const int l_iFirst = m_iNextFreePosition;
+				m_iNextFreePosition += l_iTaken;
+
+				if (a_pRetrieved != nullptr) *a_pRetrieved = l_iTaken;
+				return l_iFirst;
+			}
+
+
+			//Releases the object at the given index, moving the last active object into its place to keep the active half dense
+			void release(const int a_iIndex)
+			{
+				if (a_iIndex > -1 && a_iIndex < m_iNextFreePosition)
+				{
+					const int lastActive = m_iNextFreePosition - 1;
+
+					if (a_iIndex != lastActive) swapObjects(a_iIndex, lastActive, std::index_sequence_for<columns...>());
+
+					m_iNextFreePosition--;
+				}
+				else
+				{
+					//throw std::range_error(__FILE__ ": <SoAPool Error>: Given index was not active");
+				}
+			}
+
+
+			//Returns the start of the array holding the given column. The first activeCount() entries belong to active objects
+			template <std::size_t index>
+			typename std::tuple_element<index, std::tuple<columns...>>::type* column()
+			{
+				return std::get<index>(m_tColumns);
+			}
+
+			template <std::size_t index>
+			const typename std::tuple_element<index, std::tuple<columns...>>::type* column() const
+			{
+				return std::get<index>(m_tColumns);
+			}
+
+
+		#if __cplusplus >= 202002L
+			//Returns the given column's entries for the active objects as one contiguous span
+			template <std::size_t index>
+			std::span<typename std::tuple_element<index, std::tuple<columns...>>::type> activeSpan()
+			{
+				return std::span<typename std::tuple_element<index, std::tuple<columns...>>::type>(std::get<index>(m_tColumns), static_cast<std::size_t>(m_iNextFreePosition));
+			}
+		#endif
+
+
+			//Getter for size of pool
+			int size() const
+			{
+				return m_iSize;
+			}
+
+			//Returns number of active elements in pool
+			int activeCount() const
+			{
+				return m_iNextFreePosition;
+			}
+
+			//Returns number of free elements in pool
+			int freeCount() const
+			{
+				return m_iSize - m_iNextFreePosition;
+			}
+
+
+	};
+
+
+#endif
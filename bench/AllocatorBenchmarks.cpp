@@ -0,0 +1,166 @@
+/*
+	NovaCorps - AllocatorBenchmarks.cpp
+
+	This file benchmarks the PoolAllocator and the container adapters built on it.
+
+		Node-heavy containers (lists and hash maps) are filled with a_state.range(0) elements and
+	then destroyed, using a PoolMemoryResource, the default new/delete resource, and std::pmr's own
+	unsynchronized_pool_resource, and the same for std::list with a PoolStdAllocator against
+	std::allocator. Raw allocations of mixed sizes are timed against operator new too.
+
+*/
+
+
+#include <list>
+#include <memory_resource>
+#include <new>
+#include <unordered_map>
+
+#include <benchmark/benchmark.h>
+
+#include "PoolAllocator.h"
+#include "PoolMemoryResource.h"
+#include "PoolStdAllocator.h"
+
+
+//Fills a list and a hash map from the given resource, then destroys them
+static void fillPmrList(benchmark::State& a_state, std::pmr::memory_resource* a_pResource)
+{
+	const int l_iCount = static_cast<int>(a_state.range(0));
+
+	for (auto _ : a_state)
+	{
+		std::pmr::list<int> l_list(a_pResource);
+		for (int i = 0; i < l_iCount; i++) l_list.push_back(i);
+		benchmark::DoNotOptimize(&l_list);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * l_iCount);
+}
+
+static void fillPmrMap(benchmark::State& a_state, std::pmr::memory_resource* a_pResource)
+{
+	const int l_iCount = static_cast<int>(a_state.range(0));
+
+	for (auto _ : a_state)
+	{
+		std::pmr::unordered_map<int, int> l_map(a_pResource);
+		for (int i = 0; i < l_iCount; i++) l_map.emplace(i, i);
+		benchmark::DoNotOptimize(&l_map);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * l_iCount);
+}
+
+
+static void BM_PmrListPoolResource(benchmark::State& a_state)
+{
+	PoolMemoryResource l_resource;
+	fillPmrList(a_state, &l_resource);
+}
+
+static void BM_PmrListNewDelete(benchmark::State& a_state)
+{
+	fillPmrList(a_state, std::pmr::new_delete_resource());
+}
+
+static void BM_PmrListUnsynchronized(benchmark::State& a_state)
+{
+	std::pmr::unsynchronized_pool_resource l_resource;
+	fillPmrList(a_state, &l_resource);
+}
+
+static void BM_PmrMapPoolResource(benchmark::State& a_state)
+{
+	PoolMemoryResource l_resource;
+	fillPmrMap(a_state, &l_resource);
+}
+
+static void BM_PmrMapNewDelete(benchmark::State& a_state)
+{
+	fillPmrMap(a_state, std::pmr::new_delete_resource());
+}
+
+static void BM_PmrMapUnsynchronized(benchmark::State& a_state)
+{
+	std::pmr::unsynchronized_pool_resource l_resource;
+	fillPmrMap(a_state, &l_resource);
+}
+
+
+//The same list, but with its allocator as a template argument
+static void BM_ListPoolStdAllocator(benchmark::State& a_state)
+{
+	const int l_iCount = static_cast<int>(a_state.range(0));
+	PoolAllocator l_allocator;
+
+	for (auto _ : a_state)
+	{
+		std::list<int, PoolStdAllocator<int>> l_list{ PoolStdAllocator<int>(l_allocator) };
+		for (int i = 0; i < l_iCount; i++) l_list.push_back(i);
+		benchmark::DoNotOptimize(&l_list);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * l_iCount);
+}
+
+static void BM_ListStdAllocator(benchmark::State& a_state)
+{
+	const int l_iCount = static_cast<int>(a_state.range(0));
+
+	for (auto _ : a_state)
+	{
+		std::list<int> l_list;
+		for (int i = 0; i < l_iCount; i++) l_list.push_back(i);
+		benchmark::DoNotOptimize(&l_list);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * l_iCount);
+}
+
+
+//Allocating and freeing a run of blocks of mixed small sizes
+static const std::size_t s_pMixedSizes[] = { 8, 24, 48, 64, 100, 200, 512, 1000 };
+
+static void BM_PoolAllocatorMixed(benchmark::State& a_state)
+{
+	PoolAllocator l_allocator;
+	void* l_pBlocks[8];
+
+	for (auto _ : a_state)
+	{
+		for (int i = 0; i < 8; i++) l_pBlocks[i] = l_allocator.allocate(s_pMixedSizes[i]);
+		benchmark::DoNotOptimize(l_pBlocks);
+		for (int i = 0; i < 8; i++) l_allocator.deallocate(l_pBlocks[i], s_pMixedSizes[i]);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * 8);
+}
+
+static void BM_OperatorNewMixed(benchmark::State& a_state)
+{
+	void* l_pBlocks[8];
+
+	for (auto _ : a_state)
+	{
+		for (int i = 0; i < 8; i++) l_pBlocks[i] = ::operator new(s_pMixedSizes[i]);
+		benchmark::DoNotOptimize(l_pBlocks);
+		for (int i = 0; i < 8; i++) ::operator delete(l_pBlocks[i], s_pMixedSizes[i]);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * 8);
+}
+
+
+BENCHMARK(BM_PmrListPoolResource)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_PmrListNewDelete)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_PmrListUnsynchronized)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_PmrMapPoolResource)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_PmrMapNewDelete)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_PmrMapUnsynchronized)->Arg(1 << 10)->Arg(1 << 16);
+
+BENCHMARK(BM_ListPoolStdAllocator)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_ListStdAllocator)->Arg(1 << 10)->Arg(1 << 16);
+
+BENCHMARK(BM_PoolAllocatorMixed);
+BENCHMARK(BM_OperatorNewMixed);
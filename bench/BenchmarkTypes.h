@@ -0,0 +1,31 @@
+/*
+	NovaCorps - BenchmarkTypes.h
+
+	This header file describes the objects pooled by the benchmarks.
+
+		A Payload<size> is a plain object of the given number of bytes, so each benchmark can be run
+	for small, cache-line sized and larger objects. Pool sizes are passed in as the benchmark's
+	argument.
+
+*/
+
+
+#ifndef BENCHMARK_TYPES_H
+
+	#define BENCHMARK_TYPES_H
+
+	#include <cstddef>
+
+	template <std::size_t size>
+	struct Payload
+	{
+		unsigned char m_pBytes[size];
+	};
+
+	//Object sizes every size-dependent benchmark is run for
+	typedef Payload<16> SmallPayload;
+	typedef Payload<64> LinePayload;
+	typedef Payload<256> LargePayload;
+
+
+#endif
@@ -0,0 +1,102 @@
+/*
+	NovaCorps - ConcurrentBenchmarks.cpp
+
+	This file benchmarks the thread-safe pools from 1 to 64 threads.
+
+		Every thread retrieves and releases objects from one shared pool as fast as it can: a
+	ConcurrentPool directly, a ConcurrentPool through a PoolMagazine per thread, a ShardedPool, and
+	a plain Pool behind a mutex for comparison. Each shared pool lives for the whole run, so no
+	thread is ever left using a pool another thread has destroyed.
+
+*/
+
+
+#include <mutex>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkTypes.h"
+#include "ConcurrentPool.h"
+#include "Pool.h"
+#include "PoolMagazine.h"
+#include "ShardedPool.h"
+
+
+//Plenty of objects for 64 threads, even with a full magazine each
+static const int s_iSharedSize = 1 << 16;
+
+
+static void BM_ConcurrentPool(benchmark::State& a_state)
+{
+	static ConcurrentPool<LinePayload> s_pool(s_iSharedSize);
+
+	for (auto _ : a_state)
+	{
+		LinePayload* l_pObject = s_pool.getNext();
+		benchmark::DoNotOptimize(l_pObject);
+		s_pool.release(l_pObject);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations());
+}
+
+static void BM_PoolMagazine(benchmark::State& a_state)
+{
+	static ConcurrentPool<LinePayload> s_pool(s_iSharedSize);
+	PoolMagazine<LinePayload> l_magazine(s_pool, 64);
+
+	for (auto _ : a_state)
+	{
+		LinePayload* l_pObject = l_magazine.getNext();
+		benchmark::DoNotOptimize(l_pObject);
+		l_magazine.release(l_pObject);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations());
+}
+
+static void BM_ShardedPool(benchmark::State& a_state)
+{
+	static ShardedPool<LinePayload> s_pool(s_iSharedSize);
+
+	for (auto _ : a_state)
+	{
+		LinePayload* l_pObject = s_pool.getNext();
+		benchmark::DoNotOptimize(l_pObject);
+		s_pool.release(l_pObject);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations());
+}
+
+//What threads had to do before there was a thread-safe pool: a global lock around every call
+static void BM_MutexPool(benchmark::State& a_state)
+{
+	static Pool<LinePayload> s_pool(s_iSharedSize);
+	static std::mutex s_mutex;
+
+	for (auto _ : a_state)
+	{
+		LinePayload* l_pObject;
+
+		{
+			std::lock_guard<std::mutex> l_lock(s_mutex);
+			l_pObject = s_pool.getNext();
+		}
+
+		benchmark::DoNotOptimize(l_pObject);
+
+		{
+			std::lock_guard<std::mutex> l_lock(s_mutex);
+			s_pool.release(l_pObject);
+		}
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations());
+}
+
+
+BENCHMARK(BM_ConcurrentPool)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_PoolMagazine)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_ShardedPool)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(BM_MutexPool)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,66 @@
+/*
+	NovaCorps - MemoryBenchmarks.cpp
+
+	This file benchmarks random access over big pools in different kinds of memory.
+
+		Every object in the pool is made active, then read in a shuffled order, which is what TLB
+	misses hurt most. A SlabPool on the heap is compared against a SlabPool backed by huge pages
+	(see PoolMemory.h), and against a Pool, whose objects are each allocated separately.
+
+*/
+
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkTypes.h"
+#include "Pool.h"
+#include "PoolMemory.h"
+#include "SlabPool.h"
+
+
+//Makes every object in the pool active, then times reading all of them in a random order
+template <class pool>
+static void readRandomly(benchmark::State& a_state, pool& a_pool)
+{
+	std::vector<LinePayload*> l_vObjects(a_state.range(0));
+	for (LinePayload*& l_pObject : l_vObjects) l_pObject = a_pool.getNext();
+
+	std::shuffle(l_vObjects.begin(), l_vObjects.end(), std::mt19937(1));
+
+	for (auto _ : a_state)
+	{
+		unsigned l_iSum = 0;
+		for (LinePayload* l_pObject : l_vObjects) l_iSum += l_pObject->m_pBytes[0];
+		benchmark::DoNotOptimize(l_iSum);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * a_state.range(0));
+}
+
+
+static void BM_RandomReadSlabPoolHeap(benchmark::State& a_state)
+{
+	SlabPool<LinePayload> l_pool(static_cast<int>(a_state.range(0)));
+	readRandomly(a_state, l_pool);
+}
+
+static void BM_RandomReadSlabPoolHugePages(benchmark::State& a_state)
+{
+	SlabPool<LinePayload, PoolHugePageMemory> l_pool(static_cast<int>(a_state.range(0)), PoolHugePageMemory());
+	readRandomly(a_state, l_pool);
+}
+
+static void BM_RandomReadPool(benchmark::State& a_state)
+{
+	Pool<LinePayload> l_pool(static_cast<int>(a_state.range(0)));
+	readRandomly(a_state, l_pool);
+}
+
+
+BENCHMARK(BM_RandomReadSlabPoolHeap)->RangeMultiplier(16)->Range(1 << 13, 1 << 21);
+BENCHMARK(BM_RandomReadSlabPoolHugePages)->RangeMultiplier(16)->Range(1 << 13, 1 << 21);
+BENCHMARK(BM_RandomReadPool)->RangeMultiplier(16)->Range(1 << 13, 1 << 21);
@@ -0,0 +1,65 @@
+/*
+	NovaCorps - ParallelBenchmarks.cpp
+
+	This file benchmarks how Pool::parallelForEachActive scales across cores.
+
+		A pool of a million active objects is swept by a PoolScheduler (see PoolScheduler.h) with
+	1 to 64 threads working, the calling thread included, against a plain single-threaded
+	forEachActive over the same objects. Each visit does a little arithmetic on the object, as an
+	update loop would, so the sweep isn't limited by memory bandwidth alone. Times are wall clock,
+	so items per second should rise with the thread count up to the number of cores.
+
+*/
+
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkTypes.h"
+#include "Pool.h"
+#include "PoolScheduler.h"
+
+
+//Number of active objects swept each time
+static const int s_iActiveCount = 1 << 20;
+
+//What each visit does to an object
+static void update(LinePayload& a_object)
+{
+	for (unsigned char& l_iByte : a_object.m_pBytes) l_iByte = static_cast<unsigned char>(l_iByte * 3 + 1);
+}
+
+
+static void BM_ForEachActive(benchmark::State& a_state)
+{
+	Pool<LinePayload> l_pool(s_iActiveCount);
+	while (l_pool.getNext() != nullptr);
+
+	for (auto _ : a_state)
+	{
+		l_pool.forEachActive(update);
+		benchmark::ClobberMemory();
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * s_iActiveCount);
+}
+
+//a_state.range(0) is the number of threads working, so the scheduler has one fewer of its own
+static void BM_ParallelForEachActive(benchmark::State& a_state)
+{
+	Pool<LinePayload> l_pool(s_iActiveCount);
+	while (l_pool.getNext() != nullptr);
+
+	PoolScheduler l_scheduler(static_cast<int>(a_state.range(0)) - 1);
+
+	for (auto _ : a_state)
+	{
+		l_pool.parallelForEachActive(update, 4096, l_scheduler);
+		benchmark::ClobberMemory();
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * s_iActiveCount);
+}
+
+
+BENCHMARK(BM_ForEachActive)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParallelForEachActive)->RangeMultiplier(2)->Range(1, 64)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,323 @@
+/*
+	NovaCorps - PoolBenchmarks.cpp
+
+	This file benchmarks the single-threaded operations of Pool and SlabPool.
+
+		Retrieving and releasing are compared against plain new/delete, std::pmr's
+	unsynchronized_pool_resource, and a BlockPool, which is the same simple segregated storage that
+	boost::pool uses. Releasing is timed at both ends of the active half, for pools of a thousand up
+	to a million objects, which should cost the same. Iterating, resizing, batches and handles are
+	each timed against the way they'd be done otherwise.
+
+*/
+
+
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkTypes.h"
+#include "BlockPool.h"
+#include "Pool.h"
+#include "SlabPool.h"
+
+
+//Creating and destroying a pool of a_state.range(0) objects
+template <class type>
+static void BM_PoolConstruct(benchmark::State& a_state)
+{
+	for (auto _ : a_state)
+	{
+		Pool<type> l_pool(static_cast<int>(a_state.range(0)));
+		benchmark::DoNotOptimize(&l_pool);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * a_state.range(0));
+}
+
+template <class type>
+static void BM_SlabPoolConstruct(benchmark::State& a_state)
+{
+	for (auto _ : a_state)
+	{
+		SlabPool<type> l_pool(static_cast<int>(a_state.range(0)));
+		benchmark::DoNotOptimize(&l_pool);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * a_state.range(0));
+}
+
+//The same number of objects created and deleted one by one with new and delete
+template <class type>
+static void BM_NewConstruct(benchmark::State& a_state)
+{
+	std::vector<type*> l_vObjects(a_state.range(0));
+
+	for (auto _ : a_state)
+	{
+		for (type*& l_pObject : l_vObjects) l_pObject = new type();
+		benchmark::DoNotOptimize(l_vObjects.data());
+		for (type* l_pObject : l_vObjects) delete l_pObject;
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * a_state.range(0));
+}
+
+
+//Retrieving an object and releasing it again
+template <class type>
+static void BM_PoolGetNextRelease(benchmark::State& a_state)
+{
+	Pool<type> l_pool(static_cast<int>(a_state.range(0)));
+
+	for (auto _ : a_state)
+	{
+		type* l_pObject = l_pool.getNext();
+		benchmark::DoNotOptimize(l_pObject);
+		l_pool.release(l_pObject);
+	}
+}
+
+template <class type>
+static void BM_SlabPoolGetNextRelease(benchmark::State& a_state)
+{
+	SlabPool<type> l_pool(static_cast<int>(a_state.range(0)));
+
+	for (auto _ : a_state)
+	{
+		type* l_pObject = l_pool.getNext();
+		benchmark::DoNotOptimize(l_pObject);
+		l_pool.release(l_pObject);
+	}
+}
+
+template <class type>
+static void BM_NewDelete(benchmark::State& a_state)
+{
+	for (auto _ : a_state)
+	{
+		type* l_pObject = new type();
+		benchmark::DoNotOptimize(l_pObject);
+		delete l_pObject;
+	}
+}
+
+template <class type>
+static void BM_PmrPoolResource(benchmark::State& a_state)
+{
+	std::pmr::unsynchronized_pool_resource l_resource;
+
+	for (auto _ : a_state)
+	{
+		type* l_pObject = new (l_resource.allocate(sizeof(type), alignof(type))) type();
+		benchmark::DoNotOptimize(l_pObject);
+		l_pObject->~type();
+		l_resource.deallocate(l_pObject, sizeof(type), alignof(type));
+	}
+}
+
+//Boost-style simple segregated storage, as BlockPool and boost::pool both are
+template <class type>
+static void BM_BlockPool(benchmark::State& a_state)
+{
+	BlockPool l_blocks(sizeof(type), static_cast<int>(a_state.range(0)), alignof(type));
+
+	for (auto _ : a_state)
+	{
+		type* l_pObject = new (l_blocks.allocate()) type();
+		benchmark::DoNotOptimize(l_pObject);
+		l_pObject->~type();
+		l_blocks.deallocate(l_pObject);
+	}
+}
+
+
+//Releasing the first or last active object of a full pool, then retrieving it again. Both should be flat whatever the pool size
+static void BM_PoolReleaseFront(benchmark::State& a_state)
+{
+	const int l_iSize = static_cast<int>(a_state.range(0));
+	Pool<LinePayload> l_pool(l_iSize);
+	while (l_pool.getNext() != nullptr);
+
+	for (auto _ : a_state)
+	{
+		l_pool.release(l_pool.activeAddresses(nullptr)[0]);
+		benchmark::DoNotOptimize(l_pool.getNext());
+	}
+}
+
+static void BM_PoolReleaseBack(benchmark::State& a_state)
+{
+	const int l_iSize = static_cast<int>(a_state.range(0));
+	Pool<LinePayload> l_pool(l_iSize);
+	while (l_pool.getNext() != nullptr);
+
+	for (auto _ : a_state)
+	{
+		l_pool.release(l_pool.activeAddresses(nullptr)[l_iSize - 1]);
+		benchmark::DoNotOptimize(l_pool.getNext());
+	}
+}
+
+
+//Reading every active object of a full pool through activeAddresses
+template <class type>
+static void BM_PoolIterate(benchmark::State& a_state)
+{
+	Pool<type> l_pool(static_cast<int>(a_state.range(0)));
+	while (l_pool.getNext() != nullptr);
+
+	for (auto _ : a_state)
+	{
+		int l_iActive;
+		type** l_pActives = l_pool.activeAddresses(&l_iActive);
+
+		unsigned l_iSum = 0;
+		for (int i = 0; i < l_iActive; i++) l_iSum += l_pActives[i]->m_pBytes[0];
+		benchmark::DoNotOptimize(l_iSum);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * a_state.range(0));
+}
+
+template <class type>
+static void BM_SlabPoolIterate(benchmark::State& a_state)
+{
+	SlabPool<type> l_pool(static_cast<int>(a_state.range(0)));
+	while (l_pool.getNext() != nullptr);
+
+	for (auto _ : a_state)
+	{
+		int l_iActive;
+		type** l_pActives = l_pool.activeAddresses(&l_iActive);
+
+		unsigned l_iSum = 0;
+		for (int i = 0; i < l_iActive; i++) l_iSum += l_pActives[i]->m_pBytes[0];
+		benchmark::DoNotOptimize(l_iSum);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * a_state.range(0));
+}
+
+
+//Growing a half-active pool to double its size with size(int), then shrinking it back
+static void BM_PoolResizeCycle(benchmark::State& a_state)
+{
+	const int l_iSize = static_cast<int>(a_state.range(0));
+	Pool<LinePayload> l_pool(l_iSize);
+	for (int i = 0; i < l_iSize / 2; i++) l_pool.getNext();
+
+	for (auto _ : a_state)
+	{
+		l_pool.size(2 * l_iSize);
+		l_pool.size(l_iSize);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * l_iSize);
+}
+
+
+//Retrieving and releasing a burst of a_state.range(0) objects in one call each, and one at a time
+static void BM_PoolBatch(benchmark::State& a_state)
+{
+	const int l_iCount = static_cast<int>(a_state.range(0));
+	Pool<LinePayload> l_pool(4096);
+	std::vector<LinePayload*> l_vObjects(l_iCount);
+
+	for (auto _ : a_state)
+	{
+		l_pool.getNext(l_iCount, l_vObjects.data());
+		benchmark::DoNotOptimize(l_vObjects.data());
+		l_pool.releaseBulk(l_vObjects.data(), l_iCount);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * l_iCount);
+}
+
+static void BM_PoolBatchLoop(benchmark::State& a_state)
+{
+	const int l_iCount = static_cast<int>(a_state.range(0));
+	Pool<LinePayload> l_pool(4096);
+	std::vector<LinePayload*> l_vObjects(l_iCount);
+
+	for (auto _ : a_state)
+	{
+		for (int i = 0; i < l_iCount; i++) l_vObjects[i] = l_pool.getNext();
+		benchmark::DoNotOptimize(l_vObjects.data());
+		for (int i = 0; i < l_iCount; i++) l_pool.release(l_vObjects[i]);
+	}
+
+	a_state.SetItemsProcessed(a_state.iterations() * l_iCount);
+}
+
+
+//Retrieving and releasing through a PoolHandle, against doing it by hand with the raw pointer
+static void BM_PoolRawPointer(benchmark::State& a_state)
+{
+	Pool<LinePayload> l_pool(1024);
+
+	for (auto _ : a_state)
+	{
+		LinePayload* l_pObject = l_pool.getNext();
+		benchmark::DoNotOptimize(l_pObject);
+		l_pool.release(l_pObject);
+	}
+}
+
+static void BM_PoolHandle(benchmark::State& a_state)
+{
+	Pool<LinePayload> l_pool(1024);
+
+	for (auto _ : a_state)
+	{
+		PoolHandle<LinePayload> l_handle = l_pool.acquire();
+		benchmark::DoNotOptimize(l_handle.get());
+	}
+}
+
+
+BENCHMARK_TEMPLATE(BM_PoolConstruct, SmallPayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_PoolConstruct, LinePayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_PoolConstruct, LargePayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SlabPoolConstruct, SmallPayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SlabPoolConstruct, LinePayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SlabPoolConstruct, LargePayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_NewConstruct, SmallPayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_NewConstruct, LinePayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_NewConstruct, LargePayload)->Arg(1 << 10)->Arg(1 << 16);
+
+BENCHMARK_TEMPLATE(BM_PoolGetNextRelease, SmallPayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_PoolGetNextRelease, LinePayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_PoolGetNextRelease, LargePayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SlabPoolGetNextRelease, SmallPayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SlabPoolGetNextRelease, LinePayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SlabPoolGetNextRelease, LargePayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_NewDelete, SmallPayload);
+BENCHMARK_TEMPLATE(BM_NewDelete, LinePayload);
+BENCHMARK_TEMPLATE(BM_NewDelete, LargePayload);
+BENCHMARK_TEMPLATE(BM_PmrPoolResource, SmallPayload);
+BENCHMARK_TEMPLATE(BM_PmrPoolResource, LinePayload);
+BENCHMARK_TEMPLATE(BM_PmrPoolResource, LargePayload);
+BENCHMARK_TEMPLATE(BM_BlockPool, SmallPayload)->Arg(1 << 10);
+BENCHMARK_TEMPLATE(BM_BlockPool, LinePayload)->Arg(1 << 10);
+BENCHMARK_TEMPLATE(BM_BlockPool, LargePayload)->Arg(1 << 10);
+
+BENCHMARK(BM_PoolReleaseFront)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+BENCHMARK(BM_PoolReleaseBack)->RangeMultiplier(8)->Range(1 << 10, 1 << 20);
+
+BENCHMARK_TEMPLATE(BM_PoolIterate, SmallPayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_PoolIterate, LinePayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_PoolIterate, LargePayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SlabPoolIterate, SmallPayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SlabPoolIterate, LinePayload)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SlabPoolIterate, LargePayload)->Arg(1 << 10)->Arg(1 << 16);
+
+BENCHMARK(BM_PoolResizeCycle)->Arg(1 << 10)->Arg(1 << 16);
+
+BENCHMARK(BM_PoolBatch)->Arg(16)->Arg(256);
+BENCHMARK(BM_PoolBatchLoop)->Arg(16)->Arg(256);
+
+BENCHMARK(BM_PoolRawPointer);
+BENCHMARK(BM_PoolHandle);
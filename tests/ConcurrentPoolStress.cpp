@@ -0,0 +1,213 @@
+/*
+	NovaCorps - ConcurrentPoolStress.cpp
+
+	This file stress tests the ConcurrentPool and PoolMagazine classes.
+
+		Several threads hammer one ConcurrentPool at once with every way of retrieving and releasing
+	objects: one at a time, in batches, and through a PoolMagazine each, which refills and flushes
+	through the pool's batch getNext and chain push. Every object records which thread holds it, so
+	an object handed to two threads at once (which is what the ABA problem looks like from outside)
+	is caught the moment the second thread claims it.
+
+		Once every thread has finished and handed everything back, the pool is drained to check that
+	each object is free exactly once: none lost, and none on the free stack twice.
+
+		It's run with a tiny pool, so threads are constantly racing for the same few objects and
+	running it dry, and with a bigger one, so batches and magazines move lots of objects at a time.
+
+*/
+
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "ConcurrentPool.h"
+#include "PoolMagazine.h"
+
+//The pooled object: just a record of which thread holds it, or 0 if it's free
+struct Token
+{
+	std::atomic<int> m_iOwner{0};
+};
+
+//Number of checks that have failed so far, across every thread
+static std::atomic<int> s_iFailures{0};
+
+
+//Records a failure if a_bPassed is false, printing the first few
+static void check(const bool a_bPassed, const char* a_sWhat)
+{
+	if (!a_bPassed && s_iFailures.fetch_add(1) < 10) std::fprintf(stderr, "FAILED: %s\n", a_sWhat);
+}
+
+//Marks a token as held by the given thread, which fails if another thread already holds it
+static void claim(Token* a_pToken, const int a_iThread)
+{
+	check(a_pToken->m_iOwner.exchange(a_iThread, std::memory_order_acq_rel) == 0, "an object was handed to two threads at once");
+}
+
+//Marks a token as free again, which fails if the given thread wasn't the one holding it
+static void unclaim(Token* a_pToken, const int a_iThread)
+{
+	check(a_pToken->m_iOwner.exchange(0, std::memory_order_acq_rel) == a_iThread, "an object was released by a thread that didn't hold it");
+}
+
+
+//What each thread runs: a random mix of every way of retrieving and releasing, holding a handful of objects at a time
+static void hammer(ConcurrentPool<Token>& a_pool, const int a_iThread, const int a_iIterations)
+{
+	std::mt19937 l_random(a_iThread);
+	std::vector<Token*> l_vHeld;
+	Token* l_pBatch[8];
+
+	PoolMagazine<Token> l_magazine(a_pool, 8);
+
+	for (int i = 0; i < a_iIterations; i++)
+	{
+		switch (l_random() % 6)
+		{
+			//Retrieve one straight from the pool
+			case 0:
+			{
+				Token* l_pToken = a_pool.getNext();
+				if (l_pToken != nullptr)
+				{
+					claim(l_pToken, a_iThread);
+					l_vHeld.push_back(l_pToken);
+				}
+				break;
+			}
+
+			//Retrieve a batch straight from the pool
+			case 1:
+			{
+				const int l_iTaken = a_pool.getNext(1 + static_cast<int>(l_random() % 8), l_pBatch);
+				for (int j = 0; j < l_iTaken; j++)
+				{
+					claim(l_pBatch[j], a_iThread);
+					l_vHeld.push_back(l_pBatch[j]);
+				}
+				break;
+			}
+
+			//Retrieve one through the magazine
+			case 2:
+			{
+				Token* l_pToken = l_magazine.getNext();
+				if (l_pToken != nullptr)
+				{
+					claim(l_pToken, a_iThread);
+					l_vHeld.push_back(l_pToken);
+				}
+				break;
+			}
+
+			//Release one straight to the pool
+			case 3:
+			{
+				if (l_vHeld.empty()) break;
+
+				unclaim(l_vHeld.back(), a_iThread);
+				a_pool.release(l_vHeld.back());
+				l_vHeld.pop_back();
+				break;
+			}
+
+			//Release a batch straight to the pool
+			case 4:
+			{
+				const int l_iCount = std::min(static_cast<int>(l_vHeld.size()), 1 + static_cast<int>(l_random() % 8));
+				for (int j = 0; j < l_iCount; j++)
+				{
+					l_pBatch[j] = l_vHeld.back();
+					l_vHeld.pop_back();
+					unclaim(l_pBatch[j], a_iThread);
+				}
+				a_pool.releaseBulk(l_pBatch, l_iCount);
+				break;
+			}
+
+			//Release one through the magazine
+			default:
+			{
+				if (l_vHeld.empty()) break;
+
+				unclaim(l_vHeld.back(), a_iThread);
+				l_magazine.release(l_vHeld.back());
+				l_vHeld.pop_back();
+				break;
+			}
+		}
+
+		//Don't hoard, so the other threads get a look in
+		if (l_vHeld.size() > 16)
+		{
+			for (Token* l_pToken : l_vHeld) unclaim(l_pToken, a_iThread);
+			a_pool.releaseBulk(l_vHeld.data(), static_cast<int>(l_vHeld.size()));
+			l_vHeld.clear();
+		}
+	}
+
+	//Hand back everything still held. The magazine flushes whatever it has left when it's destroyed
+	for (Token* l_pToken : l_vHeld) unclaim(l_pToken, a_iThread);
+	a_pool.releaseBulk(l_vHeld.data(), static_cast<int>(l_vHeld.size()));
+}
+
+//Runs a_iThreads threads against a pool of a_iPoolSize objects, then checks every object made it back exactly once
+static void stress(const int a_iPoolSize, const int a_iThreads, const int a_iIterations)
+{
+	ConcurrentPool<Token> l_pool(a_iPoolSize);
+
+	std::vector<std::thread> l_vThreads;
+	for (int i = 1; i <= a_iThreads; i++)
+	{
+		l_vThreads.emplace_back(hammer, std::ref(l_pool), i, a_iIterations);
+	}
+
+	for (std::thread& l_thread : l_vThreads)
+	{
+		l_thread.join();
+	}
+
+	//Drain the pool, asking for one more than it holds: exactly every object should come out, each of them once and free
+	std::vector<Token*> l_vAll(a_iPoolSize + 1);
+	const int l_iDrained = l_pool.getNext(a_iPoolSize + 1, l_vAll.data());
+	l_vAll.resize(l_iDrained > 0 ? l_iDrained : 0);
+
+	check(l_iDrained == a_iPoolSize, "draining the pool didn't return every object");
+	check(l_pool.getNext() == nullptr, "the pool still had objects after being drained");
+
+	for (Token* l_pToken : l_vAll)
+	{
+		check(l_pool.owns(l_pToken), "the free stack held an address from outside the pool");
+		check(l_pToken->m_iOwner.load() == 0, "an object was free while still held");
+	}
+
+	std::sort(l_vAll.begin(), l_vAll.end());
+	check(std::adjacent_find(l_vAll.begin(), l_vAll.end()) == l_vAll.end(), "an object was on the free stack twice");
+}
+
+
+int main()
+{
+	const int l_iThreads = std::max(8, 2 * static_cast<int>(std::thread::hardware_concurrency()));
+
+	//Far fewer objects than threads want, so the pool keeps running dry and the same objects are fought over constantly
+	stress(4, l_iThreads, 500000);
+
+	//Plenty to go round, so batches and magazine refills and flushes move many objects at a time
+	stress(1024, l_iThreads, 500000);
+
+	if (s_iFailures.load() > 0)
+	{
+		std::fprintf(stderr, "%d checks failed\n", s_iFailures.load());
+		return 1;
+	}
+
+	std::printf("ConcurrentPool stress test passed with %d threads\n", l_iThreads);
+	return 0;
+}
@@ -0,0 +1,157 @@
+/*
+	NovaCorps - PoolRefTest.cpp
+
+	This file tests the PoolRef bookkeeping in the Pool class.
+
+		A PoolRef is an id and the generation that id had when the reference was made. Releasing an
+	object bumps its generation, so every reference made before then goes stale, whether or not the
+	object has been retrieved again since. Deleting an object (by shrinking or trimming the pool)
+	bumps it too, and puts the id on the free list threaded through the pool's positions, stored as
+	-2 - id, so the next object created reuses it. A reference to the deleted object must stay stale
+	even once its id belongs to a new object.
+
+*/
+
+
+#include <cstdio>
+#include <vector>
+
+#include "Pool.h"
+
+//Number of checks that have failed so far
+static int s_iFailures = 0;
+
+
+//Records a failure if a_bPassed is false, printing the first few
+static void check(const bool a_bPassed, const char* a_sWhat)
+{
+	if (!a_bPassed && s_iFailures++ < 10) std::fprintf(stderr, "FAILED: %s\n", a_sWhat);
+}
+
+
+//References go stale on release, and stay stale after the object is retrieved again
+static void testRelease()
+{
+	Pool<int> l_pool(4);
+
+	const PoolRef l_ref = l_pool.getNextRef();
+	int* l_pObject = l_pool.get(l_ref);
+
+	check(l_pObject != nullptr, "a fresh reference didn't resolve");
+	check(l_pool.isValid(l_ref), "a fresh reference wasn't valid");
+	check(l_pool.refOf(l_pObject).id == l_ref.id && l_pool.refOf(l_pObject).generation == l_ref.generation, "refOf didn't match getNextRef");
+
+	l_pool.release(l_ref);
+
+	check(!l_pool.isValid(l_ref), "a reference was still valid after its object was released");
+	check(l_pool.get(l_ref) == nullptr, "a released reference still resolved");
+	check(l_pool.activeCount() == 0, "releasing through a reference didn't release the object");
+
+	//The same object comes straight back out, under the same id but a newer generation
+	const PoolRef l_again = l_pool.getNextRef();
+
+	check(l_pool.get(l_again) == l_pObject, "the released object wasn't the next one retrieved");
+	check(l_again.id == l_ref.id && l_again.generation != l_ref.generation, "retrieving again didn't give a new generation");
+	check(!l_pool.isValid(l_ref), "an old reference came back to life when its object was retrieved again");
+
+	//Releasing twice through the old reference is ignored, and doesn't release the object's new use
+	l_pool.release(l_ref);
+	check(l_pool.isValid(l_again) && l_pool.activeCount() == 1, "releasing through a stale reference released the object");
+
+	//Swapping other objects around on release doesn't disturb references to objects that stay active
+	std::vector<PoolRef> l_vRefs;
+	while (l_pool.freeCount() > 0) l_vRefs.push_back(l_pool.getNextRef());
+
+	l_pool.release(l_again);
+	for (const PoolRef& l_other : l_vRefs) check(l_pool.isValid(l_other), "releasing one object invalidated a reference to another");
+
+	check(!l_pool.isValid(PoolRef{ UINT32_MAX, 0 }), "the invalid reference was valid");
+	check(!l_pool.isValid(PoolRef{ 1000, 0 }), "a reference to an id that was never handed out was valid");
+}
+
+//Deleted objects free their ids, which are handed out again newest first, and their references stay stale
+static void testFreeIds()
+{
+	Pool<int> l_pool(8);
+
+	std::vector<PoolRef> l_vRefs;
+	for (int i = 0; i < 8; i++) l_vRefs.push_back(l_pool.getNextRef());
+
+	const PoolRef l_kept = l_vRefs[0];
+	for (int i = 7; i >= 2; i--) l_pool.release(l_vRefs[i]);
+
+	//Only free objects at the end of the pool are deleted, which frees their ids
+	check(l_pool.size(2), "shrinking the pool failed");
+	check(l_pool.size() == 2 && l_pool.activeCount() == 2, "shrinking the pool didn't keep just the active objects");
+	check(l_pool.isValid(l_kept) && l_pool.isValid(l_vRefs[1]), "shrinking the pool invalidated an active object's reference");
+
+	std::vector<int> l_vDeletedIds;
+	for (int i = 2; i < 8; i++)
+	{
+		check(l_pool.atSlot(l_vRefs[i].id) == nullptr, "a deleted object's id still had an object");
+		l_vDeletedIds.push_back(static_cast<int>(l_vRefs[i].id));
+	}
+
+	//Growing back reuses every freed id before making new ones, so ids stay packed
+	check(l_pool.size(8), "growing the pool back failed");
+	check(l_pool.slotCount() == 8, "growing back made new ids instead of reusing the freed ones");
+
+	std::vector<bool> l_vSeen(8, false);
+	while (l_pool.freeCount() > 0)
+	{
+		const PoolRef l_ref = l_pool.getNextRef();
+
+		check(l_ref.id < 8 && !l_vSeen[l_ref.id], "an id was handed out twice");
+		if (l_ref.id < 8) l_vSeen[l_ref.id] = true;
+	}
+
+	//The new objects reuse the deleted objects' ids, but references to the deleted objects must not see them
+	for (int i = 2; i < 8; i++)
+	{
+		check(l_pool.atSlot(l_vRefs[i].id) != nullptr, "a freed id wasn't reused");
+		check(!l_pool.isValid(l_vRefs[i]), "a reference to a deleted object resolved to the object that reused its id");
+	}
+
+	//Growing past the freed ids makes new ones
+	check(l_pool.size(12) && l_pool.slotCount() == 12, "growing past the freed ids didn't make new ones");
+}
+
+//Trimming deletes free objects just as shrinking does
+static void testTrim()
+{
+	Pool<int> l_pool(64);
+	l_pool.setTrim(0.5f, 0.25f, 4);
+
+	std::vector<PoolRef> l_vRefs;
+	for (int i = 0; i < 64; i++) l_vRefs.push_back(l_pool.getNextRef());
+	for (int i = 63; i >= 8; i--) l_pool.release(l_vRefs[i]);
+
+	check(l_pool.trimCount() > 0 && l_pool.size() < 64, "the pool didn't trim itself");
+
+	for (int i = 0; i < 8; i++) check(l_pool.isValid(l_vRefs[i]), "trimming invalidated an active object's reference");
+	for (int i = 8; i < 64; i++) check(!l_pool.isValid(l_vRefs[i]), "a released reference was valid after trimming");
+
+	while (l_pool.getNext() != nullptr);
+	check(l_pool.size(64), "growing the trimmed pool back failed");
+	check(l_pool.slotCount() == 64, "growing the trimmed pool back didn't reuse its freed ids");
+
+	while (l_pool.getNext() != nullptr);
+	for (int i = 8; i < 64; i++) check(!l_pool.isValid(l_vRefs[i]), "a reference to a trimmed object resolved to the object that reused its id");
+}
+
+
+int main()
+{
+	testRelease();
+	testFreeIds();
+	testTrim();
+
+	if (s_iFailures > 0)
+	{
+		std::fprintf(stderr, "%d checks failed\n", s_iFailures);
+		return 1;
+	}
+
+	std::printf("PoolRef test passed\n");
+	return 0;
+}
@@ -0,0 +1,97 @@
+/*
+	NovaCorps - PoolResizeTest.cpp
+
+	This file tests resizing a Pool with size(int).
+
+		Resizing never touches active objects: shrinking stops at the number of active objects, and
+	neither growing nor shrinking moves an existing object or changes what it holds. Only free
+	objects past the new size are deleted. The table of objects keeps its room after shrinking, so
+	growing back to where it was doesn't reallocate it. Sizes of 0 or less are refused.
+
+*/
+
+
+#include <cstdio>
+#include <vector>
+
+#include "Pool.h"
+
+//Number of checks that have failed so far
+static int s_iFailures = 0;
+
+
+//Records a failure if a_bPassed is false, printing the first few
+static void check(const bool a_bPassed, const char* a_sWhat)
+{
+	if (!a_bPassed && s_iFailures++ < 10) std::fprintf(stderr, "FAILED: %s\n", a_sWhat);
+}
+
+//Checks the given objects are still the pool's actives, each still holding its index
+static void checkActives(Pool<int>& a_pool, const std::vector<int*>& a_vActives)
+{
+	check(a_pool.activeCount() == static_cast<int>(a_vActives.size()), "resizing changed the number of active objects");
+
+	for (int i = 0; i < static_cast<int>(a_vActives.size()); i++)
+	{
+		check(a_pool.refOf(a_vActives[i]).id != UINT32_MAX, "resizing deleted or freed an active object");
+		check(*a_vActives[i] == i, "resizing changed what an active object holds");
+	}
+}
+
+
+int main()
+{
+	Pool<int> l_pool(100);
+
+	std::vector<int*> l_vActives;
+	for (int i = 0; i < 40; i++)
+	{
+		l_vActives.push_back(l_pool.getNext());
+		*l_vActives.back() = i;
+	}
+
+	//Free a few from the middle, so the free half isn't just the untouched objects
+	for (int i = 0; i < 5; i++) l_pool.release(l_vActives[10 + i]);
+	l_vActives.erase(l_vActives.begin() + 10, l_vActives.begin() + 15);
+	for (int i = 0; i < static_cast<int>(l_vActives.size()); i++) *l_vActives[i] = i;
+
+	//Shrinking below the actives stops at them
+	check(l_pool.size(10), "shrinking below the actives was refused instead of stopping at them");
+	check(l_pool.size() == 35 && l_pool.freeCount() == 0, "shrinking below the actives didn't stop at them");
+	checkActives(l_pool, l_vActives);
+
+	//Growing back reuses the table's room, and adds only free objects
+	int** l_pTable = l_pool.activeAddresses(nullptr);
+
+	check(l_pool.size(100), "growing back was refused");
+	check(l_pool.size() == 100 && l_pool.freeCount() == 65, "growing back didn't add free objects");
+	check(l_pool.activeAddresses(nullptr) == l_pTable, "growing back within the table's room reallocated it");
+	checkActives(l_pool, l_vActives);
+
+	//Shrinking to a size between the actives and the current size deletes only the free objects past it
+	check(l_pool.size(60) && l_pool.size() == 60 && l_pool.freeCount() == 25, "shrinking to a size above the actives didn't land on it");
+	checkActives(l_pool, l_vActives);
+
+	//Growing past the table's room reallocates it, but still leaves every object where it was
+	check(l_pool.size(1000) && l_pool.size() == 1000, "growing past the table's room failed");
+	checkActives(l_pool, l_vActives);
+
+	//Sizes of 0 or less are refused and change nothing
+	check(!l_pool.size(0) && !l_pool.size(-4), "a size of 0 or less was accepted");
+	check(l_pool.size() == 1000, "a refused size changed the pool");
+	checkActives(l_pool, l_vActives);
+
+	//Releasing everything lets the pool shrink right down
+	for (int* l_pObject : l_vActives) l_pool.release(l_pObject);
+	check(l_pool.size(1) && l_pool.size() == 1, "an idle pool didn't shrink to the size asked for");
+	check(l_pool.getNext() != nullptr && l_pool.getNext() == nullptr, "a pool of 1 didn't hand out exactly one object");
+
+	if (s_iFailures > 0)
+	{
+		std::fprintf(stderr, "%d checks failed\n", s_iFailures);
+		return 1;
+	}
+
+	std::printf("Pool resize test passed\n");
+	return 0;
+}
@@ -0,0 +1,158 @@
+/*
+	NovaCorps - PoolSlotTest.cpp
+
+	This file tests the stable slot indices of the Pool class.
+
+		Every object keeps the slot it was given for as long as it's in the pool, however often it's
+	retrieved and released and however much the active and free halves are swapped around, so
+	slots can index side tables. A random run of retrieves and releases checks slotOf, atSlot,
+	isSlotActive and activeSlots against a record kept alongside the pool. Trimming and shrinking
+	then delete objects, which must leave every surviving object in its slot, and the slots of the
+	deleted objects empty until new objects take them over.
+
+*/
+
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Pool.h"
+
+//Number of checks that have failed so far
+static int s_iFailures = 0;
+
+
+//Records a failure if a_bPassed is false, printing the first few
+static void check(const bool a_bPassed, const char* a_sWhat)
+{
+	if (!a_bPassed && s_iFailures++ < 10) std::fprintf(stderr, "FAILED: %s\n", a_sWhat);
+}
+
+//Checks every slot of the pool against the objects we expect in them, and whether each should be active
+static void checkSlots(Pool<int>& a_pool, const std::vector<int*>& a_vObjects, const std::vector<bool>& a_vActive)
+{
+	check(a_pool.slotCount() == static_cast<int>(a_vObjects.size()), "the pool had a different number of slots than expected");
+
+	for (int i = 0; i < static_cast<int>(a_vObjects.size()); i++)
+	{
+		check(a_pool.atSlot(i) == a_vObjects[i], "a slot held a different object than expected");
+		check(a_pool.isSlotActive(i) == a_vActive[i], "a slot was active when it shouldn't be, or the other way round");
+		if (a_vObjects[i] != nullptr) check(a_pool.slotOf(a_vObjects[i]) == i, "an object's slot changed");
+	}
+
+	//activeSlots lines up with activeAddresses, and lists each active slot once
+	int l_iActive;
+	int** l_pActives = a_pool.activeAddresses(&l_iActive);
+	const int* l_pSlots = a_pool.activeSlots(nullptr);
+
+	int l_iExpected = 0;
+	for (bool l_bActive : a_vActive) l_iExpected += l_bActive;
+	check(l_iActive == l_iExpected, "the pool had a different number of actives than expected");
+
+	for (int i = 0; i < l_iActive; i++)
+	{
+		check(a_pool.slotOf(l_pActives[i]) == l_pSlots[i], "activeSlots didn't line up with activeAddresses");
+		check(a_vActive[l_pSlots[i]], "activeSlots listed a free slot");
+	}
+}
+
+
+int main()
+{
+	Pool<int> l_pool(256);
+
+	//Every object starts out in a slot of its own, all of them free
+	std::vector<int*> l_vObjects(256);
+	std::vector<bool> l_vActive(256, false);
+	for (int i = 0; i < 256; i++) l_vObjects[i] = l_pool.atSlot(i);
+
+	checkSlots(l_pool, l_vObjects, l_vActive);
+	check(l_pool.slotOf(nullptr) == -1 && l_pool.atSlot(-1) == nullptr && l_pool.atSlot(256) == nullptr, "slots outside the pool weren't empty");
+
+	//Retrieve and release at random, so objects are swapped all over the array
+	std::mt19937 l_random(7);
+	std::vector<int*> l_vHeld;
+
+	for (int l_iStep = 0; l_iStep < 20000; l_iStep++)
+	{
+		if (l_vHeld.empty() || (l_random() % 2 == 0 && l_pool.freeCount() > 0))
+		{
+			int* l_pObject = l_pool.getNext();
+			l_vHeld.push_back(l_pObject);
+			l_vActive[l_pool.slotOf(l_pObject)] = true;
+		}
+		else
+		{
+			const int l_iIndex = static_cast<int>(l_random() % l_vHeld.size());
+			int* l_pObject = l_vHeld[l_iIndex];
+
+			l_vHeld[l_iIndex] = l_vHeld.back();
+			l_vHeld.pop_back();
+
+			l_pool.release(l_pObject);
+			l_vActive[l_pool.slotOf(l_pObject)] = false;
+		}
+
+		if (l_iStep % 1000 == 0) checkSlots(l_pool, l_vObjects, l_vActive);
+	}
+
+	checkSlots(l_pool, l_vObjects, l_vActive);
+
+	//Let go of all but a few, which sends the pool into trimming itself down
+	while (l_vHeld.size() > 16)
+	{
+		l_pool.release(l_vHeld.back());
+		l_vActive[l_pool.slotOf(l_vHeld.back())] = false;
+		l_vHeld.pop_back();
+	}
+
+	l_pool.setTrim(0.5f, 0.25f, 1);
+	l_pool.release(l_vHeld.back());
+	l_vActive[l_pool.slotOf(l_vHeld.back())] = false;
+	l_vHeld.pop_back();
+
+	check(l_pool.trimCount() == 1 && l_pool.size() < 256, "the pool didn't trim itself");
+	l_pool.setTrim(1.0f, 0.0f, 0);
+
+	//Deleted objects leave their slots empty, and everything that survived stays put
+	for (int i = 0; i < 256; i++)
+	{
+		if (l_pool.atSlot(i) == nullptr)
+		{
+			check(!l_vActive[i], "trimming deleted an active object");
+			l_vObjects[i] = nullptr;
+		}
+	}
+
+	checkSlots(l_pool, l_vObjects, l_vActive);
+	for (int* l_pObject : l_vHeld) check(l_pool.slotOf(l_pObject) > -1, "an active object lost its slot in the trim");
+
+	//Shrinking as far as it will go deletes the rest of the free objects, but only those
+	l_pool.size(1);
+	check(l_pool.size() == static_cast<int>(l_vHeld.size()), "shrinking didn't stop at the active objects");
+
+	for (int i = 0; i < 256; i++) if (l_pool.atSlot(i) == nullptr) l_vObjects[i] = nullptr;
+	checkSlots(l_pool, l_vObjects, l_vActive);
+
+	//Growing back fills the empty slots with new objects before adding any more slots
+	l_pool.size(256);
+	check(l_pool.slotCount() == 256, "growing back added slots instead of reusing the empty ones");
+
+	for (int i = 0; i < 256; i++)
+	{
+		if (l_vObjects[i] == nullptr) l_vObjects[i] = l_pool.atSlot(i);
+		check(l_vObjects[i] != nullptr, "a slot was still empty after growing back");
+	}
+
+	checkSlots(l_pool, l_vObjects, l_vActive);
+
+	if (s_iFailures > 0)
+	{
+		std::fprintf(stderr, "%d checks failed\n", s_iFailures);
+		return 1;
+	}
+
+	std::printf("Pool slot test passed\n");
+	return 0;
+}
@@ -0,0 +1,185 @@
+/*
+	NovaCorps - SlabPoolDeferredTest.cpp
+
+	This file tests deferred construction in the SlabPool class.
+
+		With deferred construction the slab is reserved up front, but each object is only built the
+	first time it's retrieved, then kept alive or destroyed again on release depending on the
+	lifetime the pool was given. The pooled object here counts how many of it are alive and can be
+	told to throw from its constructors, so every retrieve can be checked for building exactly what
+	it should, and a constructor that throws can be checked for leaving its slot free to be used
+	again, with nothing leaked or destroyed twice.
+
+*/
+
+
+#include <cstdio>
+#include <stdexcept>
+
+#include "SlabPool.h"
+
+//Number of checks that have failed so far
+static int s_iFailures = 0;
+
+
+//Records a failure if a_bPassed is false, printing the first few
+static void check(const bool a_bPassed, const char* a_sWhat)
+{
+	if (!a_bPassed && s_iFailures++ < 10) std::fprintf(stderr, "FAILED: %s\n", a_sWhat);
+}
+
+
+//The pooled object: counts how many are alive, and once s_iThrowAfter more have been built, throws from its constructors.
+//s_iThrowAfter is -1 while it should never throw
+struct Counted
+{
+	static int s_iAlive;
+	static int s_iConstructed;
+	static int s_iThrowAfter;
+
+	int m_iValue;
+
+	Counted()
+		: Counted(0)
+	{
+	}
+
+	explicit Counted(const int a_iValue)
+		: m_iValue(a_iValue)
+	{
+		if (s_iThrowAfter == 0) throw std::runtime_error("constructor failed");
+		if (s_iThrowAfter > 0) s_iThrowAfter--;
+
+		s_iAlive++;
+		s_iConstructed++;
+	}
+
+	~Counted()
+	{
+		s_iAlive--;
+	}
+};
+
+int Counted::s_iAlive = 0;
+int Counted::s_iConstructed = 0;
+int Counted::s_iThrowAfter = -1;
+
+
+//Objects are only built when first retrieved, and kept alive, or not, on release according to the lifetime
+static void testLifetimes()
+{
+	{
+		SlabPool<Counted> l_pool(8, SlabLifetime::KeepAlive);
+		check(Counted::s_iAlive == 0, "a deferred pool built objects up front");
+
+		Counted* l_pFirst = l_pool.getNext();
+		Counted* l_pSecond = l_pool.emplaceNext(5);
+		check(Counted::s_iAlive == 2 && l_pSecond->m_iValue == 5, "retrieving didn't build exactly the objects retrieved");
+
+		//Kept alive on release, so retrieving it again doesn't build it again
+		l_pool.release(l_pSecond);
+		check(Counted::s_iAlive == 2, "a kept-alive object was destroyed on release");
+
+		const int l_iConstructed = Counted::s_iConstructed;
+		check(l_pool.getNext() == l_pSecond && Counted::s_iConstructed == l_iConstructed, "a kept-alive object was built again");
+		check(l_pSecond->m_iValue == 5, "a kept-alive object lost its value");
+
+		Counted* l_pBatch[4];
+		check(l_pool.getNext(4, l_pBatch) == 4 && Counted::s_iAlive == 6, "a batch retrieve didn't build each object");
+
+		l_pool.release(l_pFirst);
+	}
+
+	check(Counted::s_iAlive == 0, "a kept-alive pool didn't destroy exactly the objects it had built");
+
+	{
+		SlabPool<Counted> l_pool(8, SlabLifetime::DestroyOnRelease);
+
+		Counted* l_pObject = l_pool.emplaceNext(3);
+		l_pool.getNext();
+		check(Counted::s_iAlive == 2, "retrieving didn't build exactly the objects retrieved");
+
+		l_pool.release(l_pObject);
+		check(Counted::s_iAlive == 1, "an object wasn't destroyed on release");
+
+		check(l_pool.getNext() == l_pObject && Counted::s_iAlive == 2 && l_pObject->m_iValue == 0, "a destroyed object wasn't built afresh");
+	}
+
+	check(Counted::s_iAlive == 0, "a destroy-on-release pool didn't destroy exactly the objects still alive");
+}
+
+//A constructor that throws leaves its slot free, unconstructed and ready to be used again
+static void testThrowingConstructors()
+{
+	{
+		SlabPool<Counted> l_pool(4, SlabLifetime::DestroyOnRelease);
+		Counted* l_pFirst = l_pool.getNext();
+
+		Counted::s_iThrowAfter = 0;
+
+		bool l_bThrown = false;
+		try { l_pool.getNext(); } catch (const std::runtime_error&) { l_bThrown = true; }
+		check(l_bThrown, "getNext didn't pass on the constructor's exception");
+		check(l_pool.activeCount() == 1 && l_pool.freeCount() == 3, "getNext kept a slot whose constructor threw");
+
+		l_bThrown = false;
+		try { l_pool.emplaceNext(9); } catch (const std::runtime_error&) { l_bThrown = true; }
+		check(l_bThrown, "emplaceNext didn't pass on the constructor's exception");
+		check(l_pool.activeCount() == 1 && l_pool.freeCount() == 3, "emplaceNext kept a slot whose constructor threw");
+
+		Counted* l_pBatch[3];
+		l_bThrown = false;
+		try { l_pool.getNext(3, l_pBatch); } catch (const std::runtime_error&) { l_bThrown = true; }
+		check(l_bThrown, "a batch getNext didn't pass on the constructor's exception");
+		check(l_pool.activeCount() == 1 && l_pool.freeCount() == 3, "a batch getNext kept slots when a constructor threw");
+
+		Counted::s_iThrowAfter = -1;
+
+		//The slot handed back is the next one out, and now gets built properly
+		check(l_pool.emplaceNext(7)->m_iValue == 7 && Counted::s_iAlive == 2, "a handed back slot wasn't built on its next use");
+		check(l_pool.getNext(2, l_pBatch) == 2 && Counted::s_iAlive == 4, "the rest of the slots weren't built on their next use");
+		check(l_pool.getNext() == nullptr, "the pool had more objects than slots");
+
+		l_pool.release(l_pFirst);
+		check(Counted::s_iAlive == 3, "an object wasn't destroyed on release");
+	}
+
+	check(Counted::s_iAlive == 0, "the pool leaked or destroyed twice after a constructor threw");
+
+	//Part way through a batch, the objects already built stay free and alive, and are reused rather than built again
+	{
+		SlabPool<Counted> l_pool(4, SlabLifetime::KeepAlive);
+		Counted* l_pBatch[4];
+
+		Counted::s_iThrowAfter = 2;
+
+		bool l_bThrown = false;
+		try { l_pool.getNext(4, l_pBatch); } catch (const std::runtime_error&) { l_bThrown = true; }
+		check(l_bThrown, "a batch getNext didn't pass on the constructor's exception");
+		check(l_pool.activeCount() == 0 && Counted::s_iAlive == 2, "a batch getNext kept slots, or lost the objects it built, when a constructor threw");
+
+		Counted::s_iThrowAfter = -1;
+
+		const int l_iConstructed = Counted::s_iConstructed;
+		check(l_pool.getNext(4, l_pBatch) == 4 && Counted::s_iConstructed == l_iConstructed + 2, "a batch getNext built objects that were already built");
+		check(Counted::s_iAlive == 4, "a batch getNext didn't build the rest of the objects");
+	}
+
+	check(Counted::s_iAlive == 0, "a kept-alive pool didn't destroy exactly the objects it had built");
+}
+
+
+int main()
+{
+	testLifetimes();
+	testThrowingConstructors();
+
+	if (s_iFailures > 0)
+	{
+		std::fprintf(stderr, "%d checks failed\n", s_iFailures);
+		return 1;
+	}
+
+	std::printf("SlabPool deferred construction test passed\n");
+	return 0;
+}